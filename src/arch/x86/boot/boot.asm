@@ -9,9 +9,26 @@ BITS 16
 CODE_SEG equ gdt_code - gdt_start
 DATA_SEG equ gdt_data - gdt_start
 
-KERNEL_LOAD_SEG    equ 0x1000
-KERNEL_LOAD_OFFSET equ 0x0000
-KERNEL_LOAD_ADDR   equ (KERNEL_LOAD_SEG << 4) + KERNEL_LOAD_OFFSET
+; The packed kernel image (decompress.asm + LZ4 payload) is loaded here and
+; inflates itself to the 1 MiB link address; keep in sync with its ORG.
+IMAGE_LOAD_ADDR    equ 0x00300000
+
+; INT 13h reads land in a low-memory bounce buffer and are then copied above
+; 1 MiB through unreal mode. 127 sectors is the largest batch every BIOS accepts.
+BOUNCE_SEG         equ 0x1000
+BOUNCE_ADDR        equ BOUNCE_SEG << 4
+DAP_MAX_SECTORS    equ 127
+
+; Boot handoff block, see src/include/lux/boot.h
+BOOT_HANDOFF_ADDR      equ 0x0500
+BOOT_HANDOFF_MAGIC     equ 0x4258554C
+BOOT_HANDOFF_START_TSC equ BOOT_HANDOFF_ADDR + 0
+BOOT_HANDOFF_JUMP_TSC  equ BOOT_HANDOFF_ADDR + 8
+BOOT_HANDOFF_E820_COUNT equ BOOT_HANDOFF_ADDR + 16
+BOOT_HANDOFF_E820      equ BOOT_HANDOFF_ADDR + 24
+BOOT_E820_ENTRY_SIZE   equ 24
+BOOT_E820_MAX          equ 32
+E820_SMAP              equ 0x534D4150
 
 %include "kernel_sectors.inc"
 %ifndef KERNEL_SECTORS
@@ -35,13 +52,18 @@ start:
     mov sp, 0x7C00
     sti
 
+    rdtsc
+    mov [BOOT_HANDOFF_START_TSC], eax
+    mov [BOOT_HANDOFF_START_TSC + 4], edx
+
     mov [boot_drive], dl
 
+    lgdt [gdt_descriptor]
+    call detect_memory
+    call enable_a20
     call load_kernel
     call set_video_mode
-    call enable_a20
     cli
-    lgdt [gdt_descriptor]
     mov eax, cr0
     or eax, 0x1
     mov cr0, eax
@@ -57,20 +79,63 @@ enable_a20:
     out 0x92, al
     ret
 
+; Switch DS/ES to 4 GiB limits while staying in real mode so that the copy
+; loop can address memory above 1 MiB. Returns with interrupts disabled.
+enter_unreal_mode:
+    cli
+    push ds
+    push es
+    mov eax, cr0
+    or al, 0x1
+    mov cr0, eax
+    mov bx, DATA_SEG
+    mov ds, bx
+    mov es, bx
+    and al, 0xFE
+    mov cr0, eax
+    pop es
+    pop ds
+    ret
+
+; Walk the INT 15h E820 map straight into the handoff block. A BIOS without
+; E820 leaves the count at 0 and the kernel falls back to its static layout.
+detect_memory:
+    xor ebx, ebx
+    xor ebp, ebp
+    mov di, BOOT_HANDOFF_E820
+.next_entry:
+    mov eax, 0xE820
+    mov edx, E820_SMAP
+    mov ecx, BOOT_E820_ENTRY_SIZE
+    int 0x15
+    jc .done
+    cmp eax, E820_SMAP
+    jne .done
+    inc ebp
+    add di, BOOT_E820_ENTRY_SIZE
+    test ebx, ebx
+    jz .done
+    cmp ebp, BOOT_E820_MAX
+    jb .next_entry
+.done:
+    mov [BOOT_HANDOFF_E820_COUNT], ebp
+    ret
+
 load_kernel:
-    mov cx, KERNEL_SECTORS
-    mov dword [kernel_load_ptr], KERNEL_LOAD_ADDR
+    mov word [sectors_left], KERNEL_SECTORS
+    mov dword [kernel_load_ptr], IMAGE_LOAD_ADDR
     mov dword [dap_lba_low], 1
     mov dword [dap_lba_high], 0
+    mov word [dap_buffer_offset], 0
+    mov word [dap_buffer_segment], BOUNCE_SEG
 
-load_next_sector:
-    mov eax, [kernel_load_ptr]
-    mov dx, ax
-    and dx, 0x000F
-    mov [dap_buffer_offset], dx
-    shr eax, 4
-    mov [dap_buffer_segment], ax
-    mov word [dap_sector_count], 1
+load_next_batch:
+    mov cx, [sectors_left]
+    cmp cx, DAP_MAX_SECTORS
+    jbe .batch_sized
+    mov cx, DAP_MAX_SECTORS
+.batch_sized:
+    mov [dap_sector_count], cx
 
     mov dl, [boot_drive]
     mov si, disk_address_packet
@@ -78,10 +143,21 @@ load_next_sector:
     int 0x13
     jc disk_error
 
-    add dword [kernel_load_ptr], 512
-    add dword [dap_lba_low], 1
+    ; The BIOS may have reloaded DS/ES, so refresh the unreal limits per batch.
+    call enter_unreal_mode
+    movzx ecx, word [dap_sector_count]
+    add dword [dap_lba_low], ecx
     adc dword [dap_lba_high], 0
-    loop load_next_sector
+    sub [sectors_left], cx
+    shl ecx, 7
+    mov esi, BOUNCE_ADDR
+    mov edi, [kernel_load_ptr]
+    a32 rep movsd
+    mov [kernel_load_ptr], edi
+    sti
+
+    cmp word [sectors_left], 0
+    jne load_next_batch
     ret
 
 set_video_mode:
@@ -119,7 +195,12 @@ init_protected_mode:
     mov ss, ax
     mov esp, 0x00200000
     mov ebp, esp
-    jmp KERNEL_LOAD_ADDR
+    rdtsc
+    mov [BOOT_HANDOFF_JUMP_TSC], eax
+    mov [BOOT_HANDOFF_JUMP_TSC + 4], edx
+    mov eax, BOOT_HANDOFF_MAGIC
+    mov ebx, BOOT_HANDOFF_ADDR
+    jmp IMAGE_LOAD_ADDR
 
 halt:
     hlt
@@ -174,6 +255,7 @@ dap_lba_high:
     dd 0
 
 kernel_load_ptr: dd 0
+sectors_left: dw 0
 
 error_message: db 'Failed to load kernel via BIOS', 0
 
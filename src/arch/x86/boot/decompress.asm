@@ -0,0 +1,89 @@
+; =============================================
+; Date: 2025-12-10 00:00 UTC
+; Author: Lukas Fend <lukas.fend@outlook.com>
+; Description: Protected-mode stub that inflates the LZ4-packed kernel and jumps to _start.
+; =============================================
+; The boot sector loads this stub, immediately followed by the output of
+; tools/lz4_pack.py, at IMAGE_LOAD_ADDR. The kernel is inflated to its link
+; address and entered with the loader's EAX/EBX handoff registers intact.
+[BITS 32]
+[ORG 0x00300000]
+
+KERNEL_LINK_ADDR equ 0x00100000
+LZ4K_MAGIC       equ 0x4B345A4C
+
+LZ4K_HDR_MAGIC   equ 0
+LZ4K_HDR_RAW     equ 4
+LZ4K_HDR_PACKED  equ 8
+LZ4K_HDR_SIZE    equ 12
+
+decompress_start:
+    push eax
+    push ebx
+    cld
+
+    cmp dword [payload + LZ4K_HDR_MAGIC], LZ4K_MAGIC
+    jne .bad_image
+
+    mov esi, payload + LZ4K_HDR_SIZE
+    mov ebp, esi
+    add ebp, [payload + LZ4K_HDR_PACKED]
+    mov edi, KERNEL_LINK_ADDR
+
+.sequence:
+    ; token: high nibble = literal length, low nibble = match length - 4
+    movzx edx, byte [esi]
+    inc esi
+    mov ecx, edx
+    shr ecx, 4
+    cmp ecx, 15
+    jne .literals
+.literal_ext:
+    movzx eax, byte [esi]
+    inc esi
+    add ecx, eax
+    cmp eax, 255
+    je .literal_ext
+.literals:
+    rep movsb
+    ; The final sequence carries literals only.
+    cmp esi, ebp
+    jae .done
+
+    movzx ebx, word [esi]
+    add esi, 2
+    and edx, 15
+    cmp edx, 15
+    jne .match
+.match_ext:
+    movzx eax, byte [esi]
+    inc esi
+    add edx, eax
+    cmp eax, 255
+    je .match_ext
+.match:
+    lea ecx, [edx + 4]
+    ; Byte-wise copy so overlapping matches replicate correctly.
+    mov eax, esi
+    mov esi, edi
+    sub esi, ebx
+    rep movsb
+    mov esi, eax
+    jmp .sequence
+
+.done:
+    mov eax, edi
+    sub eax, KERNEL_LINK_ADDR
+    cmp eax, [payload + LZ4K_HDR_RAW]
+    jne .bad_image
+
+    pop ebx
+    pop eax
+    jmp KERNEL_LINK_ADDR
+
+.bad_image:
+    hlt
+    jmp .bad_image
+
+align 4
+payload:
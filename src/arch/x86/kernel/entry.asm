@@ -5,14 +5,90 @@
 ; =============================================
 [BITS 32]
 
-CODE_SEG equ 0x08
-DATA_SEG equ 0x10
+CODE_SEG equ gdt_code - gdt_start
+DATA_SEG equ gdt_data - gdt_start
+
+; Multiboot headers let QEMU (-kernel, Multiboot 1) and GRUB (multiboot2)
+; load kernel.elf directly, bypassing boot.asm. Neither requests a video
+; mode: the TTY programs VGA mode 12h itself when no BIOS stage did.
+MB1_MAGIC          equ 0x1BADB002
+MB1_FLAGS          equ 0x00000003 ; page-align modules, provide memory info
+MB2_MAGIC          equ 0xE85250D6
+MB2_ARCH_I386      equ 0
+MB2_HEADER_LENGTH  equ mb2_header_end - mb2_header
 
 global _start
+global boot_entry_tsc
 extern kernel
+extern __bss_start
+extern __bss_end
+
+section .data
+align 8
+; Lives in .data so the .bss clear below cannot wipe it.
+boot_entry_tsc: dq 0
+
+; The kernel's own flat GDT; multiboot loaders leave GDTR undefined and the
+; boot sector's table lives in memory the kernel later reuses.
+section .rodata
+align 8
+gdt_start:
+    dq 0
+gdt_code:
+    dw 0xFFFF
+    dw 0
+    db 0
+    db 0x9A
+    db 11001111b
+    db 0
+gdt_data:
+    dw 0xFFFF
+    dw 0
+    db 0
+    db 0x92
+    db 11001111b
+    db 0
+gdt_end:
+
+gdt_descriptor:
+    dw gdt_end - gdt_start - 1
+    dd gdt_start
+
+; Placed right after _start by linker.ld so both headers sit inside the first
+; 8 KiB of kernel.elf while _start stays at the link address for boot.asm.
+section .multiboot progbits alloc noexec nowrite align=8
+align 4
+mb1_header:
+    dd MB1_MAGIC
+    dd MB1_FLAGS
+    dd -(MB1_MAGIC + MB1_FLAGS)
 
+align 8
+mb2_header:
+    dd MB2_MAGIC
+    dd MB2_ARCH_I386
+    dd MB2_HEADER_LENGTH
+    dd 0x100000000 - (MB2_MAGIC + MB2_ARCH_I386 + MB2_HEADER_LENGTH)
+    ; end tag
+    dw 0
+    dw 0
+    dd 8
+mb2_header_end:
+
+section .text.entry progbits alloc exec nowrite align=16
+
+; Loaders enter with EAX = boot magic and EBX = boot data pointer; both are
+; passed on to kernel(boot_magic, boot_data).
 _start:
     cli
+    mov esi, eax
+    rdtsc
+    mov [boot_entry_tsc], eax
+    mov [boot_entry_tsc + 4], edx
+    lgdt [gdt_descriptor]
+    jmp CODE_SEG:.reload_segments
+
+.reload_segments:
     mov ax, DATA_SEG
     mov ds, ax
     mov es, ax
@@ -22,8 +98,19 @@ _start:
     mov esp, 0x00200000
     mov ebp, esp
 
+    ; The boot sector only copies the file-backed sections; zero .bss here.
+    cld
+    xor eax, eax
+    mov edi, __bss_start
+    mov ecx, __bss_end
+    sub ecx, edi
+    shr ecx, 2
+    rep stosd
+
+    push ebx
+    push esi
     call kernel
 
 .hang:
     hlt
-    jmp .hang
\ No newline at end of file
+    jmp .hang
@@ -1,7 +1,7 @@
 ; =============================================
 ; Date: 2025-12-11 00:00 UTC
 ; Author: Lukas Fend <lukas.fend@outlook.com>
-; Description: x86 IDT setup and interrupt handler stubs for PS/2 keyboard and exceptions.
+; Description: x86 IDT setup, generated stubs for the 16 IRQ lines, and page-fault/exception/APIC spurious handlers.
 ; =============================================
 
 [BITS 32]
@@ -11,15 +11,18 @@ IDT_GATE_TASK       equ 0x5
 IDT_GATE_INTERRUPT  equ 0xE
 IDT_GATE_TRAP       equ 0xF
 
+IDT_ENTRIES         equ 256
+APIC_SPURIOUS_VECTOR equ 0xFF   ; must match lux/apic.h
+
 section .data
     align 8
     idt_descriptors:
-        ; We'll populate this with 48 entries (0x00-0x2F)
+        ; All 256 vectors: exceptions 0x00-0x1F, IRQs 0x20-0x2F, APIC spurious 0xFF
         ; Each descriptor is 8 bytes
-        times 48 dq 0
+        times IDT_ENTRIES dq 0
     
     idt_register:
-        dw (48 * 8) - 1     ; limit (size - 1)
+        dw (IDT_ENTRIES * 8) - 1 ; limit (size - 1)
         dd idt_descriptors  ; base address
 
 section .text
@@ -46,8 +49,8 @@ section .text
 ; Exception handler stubs - all halt the CPU
 ; extern exception_handler_stub
 
-; IRQ handler stubs
-; extern irq_keyboard_handler
+; IRQ handler stubs - each pushes its line number and joins irq_common
+IRQ_LINES   equ 16
 
 ; PIC I/O ports
 PIC1_CMD    equ 0x20
@@ -60,7 +63,6 @@ ICW1        equ 0x11    ; ICW1: initialize
 ICW4        equ 0x01    ; ICW4: 8086 mode
 PIC1_OFFSET equ 0x20    ; vectors 0x20-0x27 for master
 PIC2_OFFSET equ 0x28    ; vectors 0x28-0x2F for slave
-EOI         equ 0x20    ; End of Interrupt
 
 global idt_init
 global interrupt_enable
@@ -103,24 +105,37 @@ idt_init:
     jmp .exception_loop
 
 .exception_done:
-    ; Set up IRQ handler (vector 0x21 = IRQ1, keyboard)
-    mov eax, irq_keyboard_handler
-    mov edx, idt_descriptors + (0x21 * 8)
-    
+    ; Page faults (vector 0x0E) may be resolved by mapping a page, so they get
+    ; an interrupt gate with their own stub.
+    create_idt_entry 0x0E, page_fault_handler, IDT_GATE_INTERRUPT
+
+    ; The local APIC's spurious vector must not be acknowledged, so it gets a bare iret
+    create_idt_entry APIC_SPURIOUS_VECTOR, apic_spurious_handler, IDT_GATE_INTERRUPT
+
+    ; Set up IRQ handlers (vectors 0x20-0x2F) from the generated stub table
+    xor ecx, ecx
+.irq_loop:
+    mov eax, [irq_stub_table + ecx * 4]
+    lea edx, [idt_descriptors + PIC1_OFFSET * 8 + ecx * 8]
+
     ; Set low 16 bits
     mov ebx, eax
     and ebx, 0xFFFF
     mov [edx], bx
-    
+
     ; Set code segment and gate type (interrupt gate, present, ring 0)
     mov word [edx + 2], 0x08
     mov byte [edx + 4], 0x00
     mov byte [edx + 5], 0x8E    ; P=1, DPL=0, gate_type=interrupt
-    
+
     ; Set high 16 bits
     mov ebx, eax
     shr ebx, 16
     mov [edx + 6], bx
+
+    inc ecx
+    cmp ecx, IRQ_LINES
+    jb .irq_loop
     
     ; Remap PIC
     ; ICW1 to both PICs
@@ -145,8 +160,9 @@ idt_init:
     out PIC1_DATA, al
     out PIC2_DATA, al
     
-    ; Mask all interrupts except IRQ1 (keyboard)
-    mov al, 0xFD        ; 11111101 = enable IRQ1 only
+    ; Mask every line except the IRQ2 cascade; irq_register() unmasks lines
+    ; as drivers claim them
+    mov al, 0xFB        ; 11111011 = cascade only
     out PIC1_DATA, al
     mov al, 0xFF        ; mask all slave interrupts for now
     out PIC2_DATA, al
@@ -175,31 +191,76 @@ exception_handler_stub:
     hlt
     jmp exception_handler_stub
 
-; IRQ keyboard handler - acknowledge and call C handler
-global irq_keyboard_handler
-irq_keyboard_handler:
-    ; Push registers to preserve them
-    push eax
-    push ecx
+; Page fault handler - hand CR2 and the error code to C, retry the access if it returns
+global page_fault_handler
+page_fault_handler:
+    pushad
+    cld                     ; C code assumes DF=0; iret restores the faulting code's flag
+
+    mov eax, [esp + 32]     ; error code pushed by the CPU
+    mov edx, [esp + 36]     ; faulting EIP
     push edx
-    push esi
-    push edi
-    
-    ; Call the C keyboard handler
-    call keyboard_irq_handler_c
-    
-    ; Send EOI (End of Interrupt) to master PIC
-    mov al, EOI
-    out PIC1_CMD, al
-    
-    ; Pop registers
-    pop edi
-    pop esi
-    pop edx
-    pop ecx
-    pop eax
-    
+    push eax
+    call page_fault_handler_c
+    add esp, 8
+
+    popad
+    add esp, 4              ; drop the error code
+    iret
+
+; APIC spurious interrupt - no EOI for this vector
+global apic_spurious_handler
+apic_spurious_handler:
+    iret
+
+; Generated IRQ stubs - push the line number so irq_common can save state uniformly
+%macro irq_stub 1
+irq_stub_%1:
+    push dword %1
+    jmp irq_common
+%endmacro
+
+irq_stub 0
+irq_stub 1
+irq_stub 2
+irq_stub 3
+irq_stub 4
+irq_stub 5
+irq_stub 6
+irq_stub 7
+irq_stub 8
+irq_stub 9
+irq_stub 10
+irq_stub 11
+irq_stub 12
+irq_stub 13
+irq_stub 14
+irq_stub 15
+
+; Common IRQ path - irq_dispatch() runs the registered handler and sends the EOIs
+irq_common:
+    pushad
+    cld
+
+    push esp                ; struct irq_frame: pushad block, IRQ line, CPU frame
+    call irq_dispatch
+    add esp, 4
+
+    popad
+    add esp, 4              ; drop the IRQ line
     iret
 
-; C function that the interrupt handler will call
-extern keyboard_irq_handler_c
+section .rodata
+    align 4
+    irq_stub_table:
+%assign irq_line 0
+%rep IRQ_LINES
+        dd irq_stub_%+irq_line
+%assign irq_line irq_line + 1
+%endrep
+
+section .text
+
+; C functions that the interrupt handlers will call
+extern irq_dispatch
+extern page_fault_handler_c
@@ -0,0 +1,21 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Local APIC and IOAPIC interrupt delivery discovered through the ACPI MADT.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define APIC_SPURIOUS_VECTOR 0xFFu /* idt.asm installs an iret-only stub here */
+
+bool apic_init(void);
+bool apic_enabled(void);
+void apic_eoi(void);
+bool apic_set_masked(unsigned int irq, bool masked);
+bool apic_irq_pending(unsigned int irq);
+bool apic_timer_start(uint32_t hz);
+bool apic_timer_active(void);
+bool apic_timer_oneshot(uint64_t ns);
+void apic_timer_periodic(void);
@@ -0,0 +1,20 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Bump-pointer arenas for short-lived allocations released all at once.
+ */
+#pragma once
+
+#include <stddef.h>
+
+struct arena_chunk;
+
+struct arena {
+	struct arena_chunk *chunks; /* newest first; allocations bump the head chunk */
+	void *last;                 /* most recent allocation, resizable in place */
+};
+
+void arena_init(struct arena *arena);
+void *arena_alloc(struct arena *arena, size_t size);
+void *arena_resize(struct arena *arena, void *ptr, size_t old_size, size_t new_size);
+void arena_release(struct arena *arena);
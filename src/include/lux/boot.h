@@ -0,0 +1,94 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Boot handoff block and the loader-independent boot information record.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The boot sector fills this block in conventional memory and jumps to _start
+ * with EAX = BOOT_HANDOFF_MAGIC and EBX = BOOT_HANDOFF_ADDR, which entry.asm
+ * forwards to kernel(). Offsets must stay in sync with the BOOT_HANDOFF_*
+ * equates in src/arch/x86/boot/boot.asm.
+ */
+#define BOOT_HANDOFF_ADDR  0x00000500u
+#define BOOT_HANDOFF_MAGIC 0x4258554Cu /* "LUXB" */
+
+#define BOOT_E820_MAX 32u
+
+struct boot_e820_entry {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+    uint32_t acpi_attributes; /* only valid when the BIOS returned 24 bytes */
+} __attribute__((packed));
+
+struct boot_handoff {
+    uint64_t loader_start_tsc; /* first instruction of the boot sector */
+    uint64_t loader_jump_tsc;  /* jump from the boot sector into _start */
+    uint32_t e820_count;       /* 0 when INT 15h E820 is unsupported */
+    uint32_t reserved;
+    struct boot_e820_entry e820[BOOT_E820_MAX];
+} __attribute__((packed));
+
+#define MULTIBOOT1_BOOT_MAGIC 0x2BADB002u
+#define MULTIBOOT2_BOOT_MAGIC 0x36D76289u
+
+#define BOOT_MMAP_MAX 32u
+
+enum boot_loader {
+    BOOT_LOADER_UNKNOWN = 0,
+    BOOT_LOADER_LUX,        /* src/arch/x86/boot/boot.asm */
+    BOOT_LOADER_MULTIBOOT1, /* e.g. qemu -kernel */
+    BOOT_LOADER_MULTIBOOT2, /* e.g. GRUB multiboot2 */
+};
+
+/* Region types follow the E820 / multiboot numbering. */
+enum boot_mmap_type {
+    BOOT_MMAP_AVAILABLE = 1,
+    BOOT_MMAP_RESERVED = 2,
+    BOOT_MMAP_ACPI_RECLAIMABLE = 3,
+    BOOT_MMAP_ACPI_NVS = 4,
+    BOOT_MMAP_BAD = 5,
+};
+
+struct boot_mmap_entry {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+};
+
+struct boot_framebuffer {
+    uint64_t addr;
+    uint32_t pitch;
+    uint32_t width;
+    uint32_t height;
+    uint8_t bpp;
+    uint8_t type; /* 0 = indexed, 1 = RGB, 2 = EGA text */
+};
+
+/*
+ * Boot information normalized across loaders; copied out of loader memory
+ * during early boot so it stays valid once that memory is reused. The memory
+ * map is sorted by base address.
+ */
+struct boot_info {
+    enum boot_loader loader;
+    bool has_meminfo;
+    uint32_t mem_lower_kb;
+    uint32_t mem_upper_kb;
+    size_t mmap_count;
+    struct boot_mmap_entry mmap[BOOT_MMAP_MAX];
+    bool has_framebuffer;
+    struct boot_framebuffer framebuffer;
+};
+
+void boot_info_init(uint32_t magic, const void *data);
+const struct boot_info *boot_info_get(void);
+uint64_t boot_info_available_bytes(void);
+const char *boot_loader_name(enum boot_loader loader);
+const char *boot_mmap_type_name(uint32_t type);
@@ -0,0 +1,39 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Boot-phase timestamp record for measuring startup latency.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lux/boot.h>
+
+enum boot_phase {
+    BOOT_PHASE_LOADER_START = 0,
+    BOOT_PHASE_LOADER_JUMP,
+    BOOT_PHASE_ENTRY,
+    BOOT_PHASE_HEAP_INIT,
+    BOOT_PHASE_TTY_INIT,
+    BOOT_PHASE_IDT_INIT,
+    BOOT_PHASE_ATA_INIT,
+    BOOT_PHASE_FS_MOUNT,
+    BOOT_PHASE_PROMPT,
+    BOOT_PHASE_COUNT
+};
+
+/**
+ * Import the timestamps captured by the boot sector and the entry stub.
+ * Must run before anything overwrites the boot handoff block.
+ */
+void boottime_init(const struct boot_handoff *handoff);
+
+/**
+ * Record the current TSC for `phase`. Only the first mark of each phase is kept,
+ * so callers on repeating paths (such as the prompt loop) may call it freely.
+ */
+void boottime_mark(enum boot_phase phase);
+
+bool boottime_get(enum boot_phase phase, uint64_t *tsc);
+const char *boottime_phase_name(enum boot_phase phase);
@@ -0,0 +1,251 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Inline helpers for CPUID, model-specific registers, and control registers.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* CPUID leaf 1 EDX feature bits. */
+#define CPUID_1_EDX_PSE  (1u << 3)
+#define CPUID_1_EDX_TSC  (1u << 4)
+#define CPUID_1_EDX_MSR  (1u << 5)
+#define CPUID_1_EDX_APIC (1u << 9)
+#define CPUID_1_EDX_PAT  (1u << 16)
+
+#define CR0_PG  (1u << 31)
+#define CR4_PSE (1u << 4)
+
+#define MSR_IA32_APIC_BASE 0x01Bu
+#define MSR_IA32_PAT       0x277u
+
+/**
+ * Check whether the CPU implements CPUID by toggling the EFLAGS.ID bit.
+ *
+ * @returns `true` if EFLAGS.ID can be changed (CPUID is available), `false` otherwise.
+ */
+static inline bool cpu_has_cpuid(void)
+{
+    uint32_t before;
+    uint32_t after;
+    __asm__ volatile (
+        "pushfl\n\t"
+        "pushfl\n\t"
+        "popl %0\n\t"
+        "movl %0, %1\n\t"
+        "xorl $0x200000, %1\n\t"
+        "pushl %1\n\t"
+        "popfl\n\t"
+        "pushfl\n\t"
+        "popl %1\n\t"
+        "popfl"
+        : "=&r"(before), "=&r"(after));
+    return ((before ^ after) & 0x200000u) != 0;
+}
+
+#define EFLAGS_IF 0x200u
+
+#ifdef LUX_IRQ_TRACE
+/* Interrupts-disabled span tracking in irq.c; called with interrupts disabled. */
+void irq_off_begin(uint32_t site);
+void irq_off_end(void);
+
+/**
+ * Capture an address inside the caller to attribute an interrupts-off span to.
+ *
+ * @returns Address of the instruction following the capture.
+ */
+static inline __attribute__((always_inline)) uint32_t cpu_irq_site(void)
+{
+    uint32_t site;
+    __asm__ volatile ("movl $1f, %0\n1:" : "=r"(site));
+    return site;
+}
+#endif
+
+/**
+ * Disable interrupts and return the previous EFLAGS for cpu_irq_restore().
+ *
+ * In IRQ_TRACE=1 builds, a save that actually disables interrupts starts an
+ * interrupts-off span attributed to this call site.
+ *
+ * @returns EFLAGS before interrupts were disabled.
+ */
+static inline uint32_t cpu_irq_save(void)
+{
+    uint32_t flags;
+    __asm__ volatile ("pushfl\n\tpopl %0\n\tcli" : "=r"(flags) : : "memory");
+#ifdef LUX_IRQ_TRACE
+    if (flags & EFLAGS_IF) {
+        irq_off_begin(cpu_irq_site());
+    }
+#endif
+    return flags;
+}
+
+/**
+ * Re-enable interrupts if they were enabled when cpu_irq_save() was called.
+ *
+ * @param flags Value returned by cpu_irq_save().
+ */
+static inline void cpu_irq_restore(uint32_t flags)
+{
+    if (flags & EFLAGS_IF) {
+#ifdef LUX_IRQ_TRACE
+        irq_off_end();
+#endif
+        __asm__ volatile ("sti" : : : "memory");
+    }
+}
+
+/**
+ * Disable interrupts for a section whose end is not a cpu_irq_restore(), such
+ * as a wake-up check before cpu_idle() or the gap between softirq passes.
+ * Traced like cpu_irq_save() in IRQ_TRACE=1 builds.
+ */
+static inline void cpu_irq_disable(void)
+{
+    __asm__ volatile ("cli" : : : "memory");
+#ifdef LUX_IRQ_TRACE
+    irq_off_begin(cpu_irq_site());
+#endif
+}
+
+/**
+ * Enable interrupts, ending the span started by cpu_irq_disable() or by interrupt entry.
+ */
+static inline void cpu_irq_enable(void)
+{
+#ifdef LUX_IRQ_TRACE
+    irq_off_end();
+#endif
+    __asm__ volatile ("sti" : : : "memory");
+}
+
+/**
+ * Report whether maskable interrupts are currently enabled.
+ *
+ * @returns `true` if EFLAGS.IF is set.
+ */
+static inline bool cpu_interrupts_enabled(void)
+{
+    uint32_t flags;
+    __asm__ volatile ("pushfl\n\tpopl %0" : "=r"(flags));
+    return (flags & EFLAGS_IF) != 0;
+}
+
+/**
+ * Keep the compiler from moving memory accesses across this point.
+ *
+ * x86 does not reorder stores with other stores or loads with other loads, so
+ * on this uniprocessor kernel that is all a producer/consumer handoff needs.
+ */
+static inline void cpu_barrier(void)
+{
+    __asm__ volatile ("" : : : "memory");
+}
+
+/**
+ * Execute CPUID for the given leaf and subleaf.
+ *
+ * @param leaf Value loaded into EAX.
+ * @param subleaf Value loaded into ECX.
+ * @param eax Receives EAX.
+ * @param ebx Receives EBX.
+ * @param ecx Receives ECX.
+ * @param edx Receives EDX.
+ */
+static inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+    __asm__ volatile ("cpuid" : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx) : "a"(leaf), "c"(subleaf));
+}
+
+/**
+ * Read a model-specific register.
+ *
+ * @param msr MSR index.
+ * @returns The 64-bit register value.
+ */
+static inline uint64_t rdmsr(uint32_t msr)
+{
+    uint32_t low;
+    uint32_t high;
+    __asm__ volatile ("rdmsr" : "=a"(low), "=d"(high) : "c"(msr));
+    return ((uint64_t)high << 32) | low;
+}
+
+/**
+ * Write a model-specific register.
+ *
+ * @param msr MSR index.
+ * @param value 64-bit value to store.
+ */
+static inline void wrmsr(uint32_t msr, uint64_t value)
+{
+    __asm__ volatile ("wrmsr" : : "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)) : "memory");
+}
+
+static inline uint32_t read_cr0(void)
+{
+    uint32_t value;
+    __asm__ volatile ("movl %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr0(uint32_t value)
+{
+    __asm__ volatile ("movl %0, %%cr0" : : "r"(value) : "memory");
+}
+
+/**
+ * Read CR2, which holds the linear address of the last page fault.
+ *
+ * @returns The faulting address.
+ */
+static inline uint32_t read_cr2(void)
+{
+    uint32_t value;
+    __asm__ volatile ("movl %%cr2, %0" : "=r"(value));
+    return value;
+}
+
+static inline uint32_t read_cr3(void)
+{
+    uint32_t value;
+    __asm__ volatile ("movl %%cr3, %0" : "=r"(value));
+    return value;
+}
+
+/**
+ * Load CR3; this also flushes all non-global TLB entries.
+ *
+ * @param value Physical address of the page directory.
+ */
+static inline void write_cr3(uint32_t value)
+{
+    __asm__ volatile ("movl %0, %%cr3" : : "r"(value) : "memory");
+}
+
+static inline uint32_t read_cr4(void)
+{
+    uint32_t value;
+    __asm__ volatile ("movl %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr4(uint32_t value)
+{
+    __asm__ volatile ("movl %0, %%cr4" : : "r"(value) : "memory");
+}
+
+/**
+ * Invalidate the TLB entry covering a linear address.
+ *
+ * @param addr Any address inside the page to invalidate.
+ */
+static inline void invlpg(const void *addr)
+{
+    __asm__ volatile ("invlpg (%0)" : : "r"(addr) : "memory");
+}
@@ -0,0 +1,41 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Typed kernel event bus with per-type subscriber lists and deferred delivery from IRQ context.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define EVENT_MAX_SUBSCRIPTIONS 32u
+#define EVENT_QUEUE_CAPACITY    64u /* events posted but not yet delivered */
+
+enum event_type {
+	EVENT_CTRL_C = 0,  /* Ctrl-C typed; data unused */
+	EVENT_KEY,         /* key press queued; data = (uint8_t)symbol | modifiers << 8 */
+	EVENT_TIMER_TICK,  /* clock tick; data = low 32 bits of clock_ticks() */
+	EVENT_DISK_DONE,   /* ATA transfer finished; data = first LBA */
+	EVENT_LOW_MEMORY,  /* free page frames fell below 1/16 of the managed ones; data = free frames */
+	EVENT_TYPE_MAX
+};
+
+struct event {
+	enum event_type type;
+	uint32_t data;
+};
+
+typedef void (*event_handler_t)(const struct event *event, void *context);
+
+struct event_stats {
+	uint64_t raised[EVENT_TYPE_MAX]; /* delivered to the subscribers of each type */
+	uint64_t dropped;                /* posts lost because the deferred queue was full */
+};
+
+void event_bus_init(void);
+int event_subscribe(enum event_type type, event_handler_t handler, void *context);
+bool event_unsubscribe(int id);
+bool event_has_subscribers(enum event_type type);
+void event_raise(enum event_type type, uint32_t data);
+bool event_post(enum event_type type, uint32_t data);
+bool event_get_stats(struct event_stats *stats);
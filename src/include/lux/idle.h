@@ -0,0 +1,18 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: CPU idle path (sti; hlt) with idle-time accounting.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct idle_stats {
+	uint64_t idle_cycles; /* clock_cycles() spent halted, including the waking interrupt */
+	uint64_t halts;       /* number of cpu_idle() calls */
+	uint64_t tickless;    /* halts with the periodic tick stopped */
+};
+
+void cpu_idle(void);
+bool idle_get_stats(struct idle_stats *stats);
@@ -12,7 +12,9 @@
  *
  * Sets up the IDT with:
  * - Exceptions (0x00-0x1F) with default handlers that halt the CPU
- * - IRQ handlers (0x20-0x2F) that acknowledge and forward to keyboard driver
+ * - Page faults (0x0E) routed to page_fault_handler_c(), which maps heap window pages on demand
+ * - IRQs (0x20-0x2F) through generated stubs into irq_dispatch(); every line starts
+ *   masked until a driver claims it with irq_register()
  * 
  * Remaps the PIC so:
  * - Master PIC interrupts appear as vectors 0x20-0x27
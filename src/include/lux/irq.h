@@ -0,0 +1,53 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Hardware IRQ registration, dispatch, and per-line counters (8259 PIC pair or IOAPIC).
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define IRQ_LINES       16u
+#define IRQ_VECTOR_BASE 0x20u /* IRQ n arrives on vector IRQ_VECTOR_BASE + n */
+
+#define IRQ_TIMER    0u
+#define IRQ_KEYBOARD 1u
+#define IRQ_CASCADE  2u
+
+/* Handler time histogram: bucket 0 counts < 2^(IRQ_HIST_SHIFT + 1) cycles, bucket n >= 1 counts
+ * [2^(IRQ_HIST_SHIFT + n), 2^(IRQ_HIST_SHIFT + n + 1)), and the last bucket everything above. */
+#define IRQ_HIST_BUCKETS 16u
+#define IRQ_HIST_SHIFT   8u
+
+typedef void (*irq_handler_t)(unsigned int irq, void *context);
+
+/* Stack layout built by the IRQ stubs in idt.asm, lowest address first. */
+struct irq_frame {
+	uint32_t edi, esi, ebp, esp, ebx, edx, ecx, eax; /* pushad; esp is the value before pushad */
+	uint32_t irq;                                     /* line number pushed by the stub */
+	uint32_t eip, cs, eflags;                         /* pushed by the CPU; no ss:esp, same ring */
+};
+
+struct irq_stats {
+	uint64_t counts[IRQ_LINES];   /* interrupts delivered to a handler */
+	uint64_t spurious[IRQ_LINES]; /* spurious PIC IRQ7/IRQ15 and lines without a handler */
+	uint64_t cycles[IRQ_LINES];   /* clock_cycles() from dispatch entry to the EOI, summed */
+	uint32_t max_cycles[IRQ_LINES];
+	uint32_t histogram[IRQ_LINES][IRQ_HIST_BUCKETS];
+	uint32_t handlers[IRQ_LINES]; /* handler address for symbol lookup, 0 if none */
+	uint64_t irqoff_max;          /* longest interrupts-off section in cycles (IRQ_TRACE=1 builds) */
+	uint32_t irqoff_site;         /* call site or IRQ handler that began it */
+	bool irqoff_traced;           /* built with LUX_IRQ_TRACE */
+};
+
+bool irq_init(void);
+const char *irq_controller(void);
+bool irq_pending(unsigned int irq);
+bool irq_register(unsigned int irq, irq_handler_t handler, void *context);
+bool irq_unregister(unsigned int irq);
+uint64_t irq_count(unsigned int irq);
+bool irq_get_stats(struct irq_stats *stats);
+void irq_reset_stats(void);
+const struct irq_frame *irq_current_frame(void);
+void irq_dispatch(struct irq_frame *frame);
@@ -32,16 +32,18 @@ struct keyboard_event {
 	bool pressed;
 };
 
+bool keyboard_init(void);
 void keyboard_set_layout(enum keyboard_layout layout);
 char keyboard_read_char(void);
 bool keyboard_poll_char(char *out_char);
 bool keyboard_poll_event(struct keyboard_event *event);
 bool keyboard_read_event(struct keyboard_event *event);
+void keyboard_wait(void);
 uint8_t keyboard_modifiers(void);
 
 /**
- * Process a single scancode from an interrupt handler.
- * Used by IRQ1 (keyboard interrupt) to handle scancodes without polling.
+ * Process a single scancode received through IRQ1.
+ * Used by the keyboard softirq to handle scancodes without polling.
  * 
  * @param scancode The PS/2 scancode to process.
  * @param out_char Optional pointer to receive the translated character (may be NULL).
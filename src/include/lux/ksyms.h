@@ -0,0 +1,24 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Kernel symbol table embedded at link time (tools/gen_ksyms.py) for address lookups.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct ksym {
+	uint32_t addr; /* start address */
+	uint32_t size; /* bytes, or 0 if unknown (extends to the next symbol) */
+	uint32_t name; /* offset into ksym_names */
+};
+
+/* Generated into build/ksyms.c, sorted by address; empty during the first link. */
+extern const struct ksym ksym_table[];
+extern const uint32_t ksym_count;
+extern const char ksym_names[];
+
+int ksym_index(uint32_t addr);
+const char *ksym_name(int index);
+bool ksym_lookup(uint32_t addr, const char **name, uint32_t *offset);
@@ -1,12 +1,13 @@
 /*
  * Date: 2025-12-10 00:00 UTC
  * Author: Lukas Fend <lukas.fend@outlook.com>
- * Description: Basic kernel heap interface for dynamic memory allocation.
+ * Description: Kernel heap and physical page allocator interfaces.
  */
 #pragma once
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 struct heap_stats {
 	size_t total_bytes;
@@ -17,8 +18,85 @@ struct heap_stats {
 	size_t free_block_count;
 };
 
+#define PAGE_SIZE      4096u
+#define PAGE_MAX_ORDER 10u /* 4 MiB blocks */
+
+/*
+ * Virtual range the heap grows into once paging is on; its pages are backed by
+ * zeroed frames on first touch. Physical RAM from here up is left unmanaged.
+ */
+#define HEAP_WINDOW_BASE 0x80000000u
+#define HEAP_WINDOW_SIZE 0x10000000u /* 256 MiB */
+#define HEAP_WINDOW_TABLE_SPAN 0x00400000u /* window bytes mapped by one page table */
+
+struct page_stats {
+	size_t total_pages;
+	size_t free_pages;
+	size_t reserved_pages; /* free, but promised to page_alloc_reserved() */
+	size_t free_blocks[PAGE_MAX_ORDER + 1];
+};
+
+void page_alloc_init(void);
+void *page_alloc(size_t order);
+void page_free(void *page, size_t order);
+bool page_reserve(size_t count);
+void page_unreserve(size_t count);
+void *page_alloc_reserved(void);
+size_t page_order_for_size(size_t size);
+void page_mark_slab(void *page, size_t order);
+size_t page_slab_order(const void *addr);
+bool page_get_stats(struct page_stats *stats);
+
+#define SLAB_MIN_SIZE    8u
+#define SLAB_MAX_SIZE    2048u
+#define SLAB_CLASS_COUNT 9u /* 8, 16, ..., 2048 */
+
+struct slab_class_stats {
+	size_t object_size;
+	size_t hits;           /* allocations served from an existing slab */
+	size_t misses;         /* allocations that needed a fresh slab */
+	size_t objects_in_use;
+	size_t objects_total;  /* capacity of all slabs in the class */
+	size_t slab_count;
+};
+
+void *slab_alloc(size_t size);
+bool slab_free(void *ptr);
+size_t slab_object_size(const void *ptr);
+bool slab_get_stats(size_t class_index, struct slab_class_stats *stats);
+
 void heap_init(void);
+bool heap_add_window(void *base, size_t size);
+bool heap_window_committed(uintptr_t addr);
 void *malloc(size_t size);
 void free(void *ptr);
 void *calloc(size_t count, size_t size);
+void *realloc(void *ptr, size_t size);
+void *aligned_alloc(size_t alignment, size_t size);
 bool heap_get_stats(struct heap_stats *stats);
+
+#define HEAP_PROFILE_TOP_SITES    8u
+#define HEAP_PROFILE_SIZE_CLASSES 16u /* up to 8 B, 16 B, ..., 128 KiB, then anything larger */
+
+struct heap_profile_site {
+	uintptr_t caller;   /* return address of the malloc/free call */
+	size_t allocations; /* malloc, calloc and realloc calls */
+	size_t frees;
+	size_t bytes;       /* total bytes requested */
+	uint64_t cycles;    /* TSC cycles spent in the allocator for this site */
+};
+
+struct heap_profile {
+	size_t site_count;      /* valid entries in sites[], busiest first */
+	size_t untracked_calls; /* calls from sites that did not fit the site table */
+	struct heap_profile_site sites[HEAP_PROFILE_TOP_SITES];
+	size_t size_classes[HEAP_PROFILE_SIZE_CLASSES];
+	size_t malloc_calls;
+	size_t free_calls;
+	uint64_t malloc_p50;    /* latencies in TSC cycles */
+	uint64_t malloc_p99;
+	uint64_t free_p50;
+	uint64_t free_p99;
+};
+
+bool heap_get_profile(struct heap_profile *profile);
@@ -0,0 +1,28 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Identity-mapped paging with per-range cache attributes.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PAGING_LARGE_PAGE_SIZE 0x400000u
+
+#define VGA_APERTURE_BASE 0x000A0000u
+#define VGA_APERTURE_SIZE 0x00020000u
+
+enum paging_cache {
+	PAGING_CACHE_WRITE_BACK = 0,
+	PAGING_CACHE_WRITE_COMBINING, /* falls back to uncached without PAT */
+	PAGING_CACHE_UNCACHED,
+};
+
+bool paging_init(void);
+bool paging_enabled(void);
+bool paging_has_pat(void);
+bool paging_set_cache(uintptr_t base, size_t length, enum paging_cache cache);
+bool paging_has_heap_window(void);
+bool paging_handle_fault(uintptr_t addr, uint32_t error);
@@ -0,0 +1,42 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Statistical sampling profiler driven by the timer interrupt.
+ */
+#pragma once
+
+#include <lux/irq.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROFILE_SAMPLES     4096u /* ring capacity; the oldest samples are overwritten */
+#define PROFILE_STACK_DEPTH 4u    /* callers recorded per sample in PROFILE_FRAMES=1 builds */
+
+struct profile_sample {
+	uint32_t eip;                          /* interrupted instruction */
+	uint32_t callers[PROFILE_STACK_DEPTH]; /* return addresses from the frame-pointer chain, 0-terminated */
+};
+
+struct profile_stats {
+	uint64_t samples;  /* taken since the last reset, including overwritten ones */
+	uint32_t stored;   /* samples currently held in the ring */
+	uint32_t period;   /* timer ticks between samples */
+	bool running;
+	bool frames;       /* built with frame pointers; callers[] is filled in */
+};
+
+struct profile_entry {
+	int symbol;     /* ksym index, or -1 for addresses outside the symbol table */
+	uint32_t self;  /* samples whose EIP fell inside the symbol */
+	uint32_t total; /* samples with the symbol anywhere on the recorded stack */
+};
+
+bool profile_start(uint32_t period_ticks);
+void profile_stop(void);
+bool profile_active(void);
+void profile_reset(void);
+void profile_tick(const struct irq_frame *frame);
+bool profile_get_stats(struct profile_stats *stats);
+size_t profile_top(struct profile_entry *entries, size_t max_entries);
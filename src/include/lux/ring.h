@@ -0,0 +1,96 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Lock-free single-producer/single-consumer byte ring for handing IRQ data to bottom halves.
+ */
+#pragma once
+
+#include <lux/cpu.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * The producer only writes `head`, the consumer only writes `tail`; both are
+ * free-running and masked on access, so `head - tail` is the fill level.
+ */
+struct ring {
+	uint8_t *data;
+	uint32_t mask;             /* capacity - 1; capacity is a power of two */
+	volatile uint32_t head;    /* next slot to fill, advanced by the producer */
+	volatile uint32_t tail;    /* next slot to drain, advanced by the consumer */
+	volatile uint32_t dropped; /* bytes rejected because the ring was full */
+};
+
+/**
+ * Attach a ring to caller-provided storage and empty it.
+ *
+ * @param ring Ring to initialize; must not be NULL.
+ * @param buffer Backing storage of `capacity` bytes.
+ * @param capacity Size of `buffer`; must be a non-zero power of two.
+ * @returns `true` on success, `false` if an argument is invalid.
+ */
+static inline bool ring_init(struct ring *ring, uint8_t *buffer, size_t capacity)
+{
+    if (!ring || !buffer || !capacity || (capacity & (capacity - 1u)) || capacity > 0x80000000u) {
+        return false;
+    }
+    ring->data = buffer;
+    ring->mask = (uint32_t)capacity - 1u;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+    return true;
+}
+
+/**
+ * Append one byte; producer side only.
+ *
+ * @param ring Ring to append to.
+ * @param value Byte to store.
+ * @returns `true` if stored, `false` if the ring was full (the byte is counted as dropped).
+ */
+static inline bool ring_push(struct ring *ring, uint8_t value)
+{
+    uint32_t head = ring->head;
+    if (head - ring->tail > ring->mask) {
+        ring->dropped = ring->dropped + 1u;
+        return false;
+    }
+    ring->data[head & ring->mask] = value;
+    cpu_barrier();
+    ring->head = head + 1u;
+    return true;
+}
+
+/**
+ * Remove the oldest byte; consumer side only.
+ *
+ * @param ring Ring to drain.
+ * @param value Receives the byte; must not be NULL.
+ * @returns `true` if a byte was removed, `false` if the ring was empty.
+ */
+static inline bool ring_pop(struct ring *ring, uint8_t *value)
+{
+    uint32_t tail = ring->tail;
+    if (tail == ring->head) {
+        return false;
+    }
+    cpu_barrier();
+    *value = ring->data[tail & ring->mask];
+    cpu_barrier();
+    ring->tail = tail + 1u;
+    return true;
+}
+
+/**
+ * Check whether the ring holds no data.
+ *
+ * @param ring Ring to inspect.
+ * @returns `true` if empty.
+ */
+static inline bool ring_empty(const struct ring *ring)
+{
+    return ring->head == ring->tail;
+}
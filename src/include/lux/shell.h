@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include <lux/arena.h>
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -13,6 +14,7 @@ struct shell_io {
 	size_t input_len;
 	void (*write)(void *context, const char *data, size_t len);
 	void *context;
+	struct arena *arena; /* scratch memory released when the command line finishes */
 };
 
 #define SHELL_PATH_MAX 256u
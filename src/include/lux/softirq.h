@@ -0,0 +1,22 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Deferred interrupt work (bottom halves) run with interrupts enabled.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SOFTIRQ_LINES 8u
+
+#define SOFTIRQ_KEYBOARD 0u
+#define SOFTIRQ_EVENT    1u /* deferred event bus delivery */
+#define SOFTIRQ_TIMER    2u /* expired timer callbacks */
+
+typedef void (*softirq_handler_t)(void *context);
+
+bool softirq_register(unsigned int nr, softirq_handler_t handler, void *context);
+void softirq_raise(unsigned int nr);
+bool softirq_pending(void);
+void softirq_run(void);
@@ -1,9 +1,75 @@
 #pragma once
 
+#include <lux/tsc.h>
+
+#include <stdbool.h>
 #include <stdint.h>
 
+#define CLOCK_HZ 1000u /* IRQ0 rate */
+
+/**
+ * Program PIT channel 0 as a CLOCK_HZ rate generator, reset the tick counter,
+ * claim IRQ0, and calibrate the TSC. With the APICs in use and a TSC clocksource,
+ * the LAPIC timer then takes over the tick. Call after irq_init().
+ */
+void clock_init(void);
+
+/**
+ * Raw timestamp for profiling: the TSC, a single RDTSC with no conversion.
+ * Convert differences with clock_cycles_to_ns().
+ */
+static inline uint64_t clock_cycles(void)
+{
+    return tsc_read();
+}
+
 /**
- * Busy-wait for approximately the requested number of milliseconds.
- * Accuracy depends on CPU speed because the kernel lacks a hardware timer.
+ * Convert a clock_cycles() difference to nanoseconds (multiply and shift, no division).
+ * Returns 0 if the TSC could not be calibrated.
+ */
+uint64_t clock_cycles_to_ns(uint64_t cycles);
+
+/**
+ * Name of the source behind clock_ns(): "tsc" or "pit".
+ */
+const char *clock_source(void);
+
+/**
+ * Number of CLOCK_HZ tick periods since clock_init(). Derived from clock_ns()
+ * with a TSC clock, since the tick stops while the CPU idles tickless.
+ */
+uint64_t clock_ticks(void);
+
+/**
+ * Monotonic time since clock_init() in milliseconds.
+ */
+uint64_t clock_ms(void);
+
+/**
+ * Monotonic time since clock_init() in nanoseconds. Derived from the TSC when
+ * it runs at a constant rate, otherwise interpolated between PIT ticks from the
+ * channel 0 counter (about 838 ns resolution).
+ */
+uint64_t clock_ns(void);
+
+/**
+ * Sleep for at least the requested number of milliseconds, halting the CPU
+ * until a wake-up timer for the deadline fires. Falls back to a calibrated
+ * busy-wait while the clock is not running or interrupts are disabled.
  */
 void sleep_ms(uint32_t milliseconds);
+
+/**
+ * Like sleep_ms(), but give up early once `stop` returns true (polled after
+ * every wake-up with interrupts disabled). Returns whether the full duration elapsed.
+ */
+bool sleep_ms_interruptible(uint32_t milliseconds, bool (*stop)(void));
+
+/**
+ * Tickless idle hooks for cpu_idle(): clock_idle_enter() (interrupts disabled)
+ * replaces the periodic tick with a one-shot for the next timer deadline when
+ * nothing depends on the tick and returns whether it did; clock_idle_exit()
+ * restores the tick after the halt.
+ */
+bool clock_idle_enter(void);
+void clock_idle_exit(void);
@@ -0,0 +1,28 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: One-shot kernel timers on clock_ns() deadlines, expired from a softirq.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TIMER_NO_DEADLINE 0xFFFFFFFFFFFFFFFFull
+
+typedef void (*timer_fn_t)(void *context);
+
+struct timer {
+	uint64_t deadline;  /* absolute clock_ns() value */
+	timer_fn_t fn;      /* run from the timer softirq; NULL for a pure wake-up */
+	void *context;
+	struct timer *next; /* pending list, sorted by deadline */
+	bool armed;
+};
+
+void timer_init(void);
+void timer_setup(struct timer *timer, timer_fn_t fn, void *context);
+bool timer_arm(struct timer *timer, uint64_t deadline);
+bool timer_cancel(struct timer *timer);
+uint64_t timer_next_deadline(void);
+void timer_check(void);
@@ -0,0 +1,43 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Time stamp counter access and PIT-based frequency calibration.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Read the processor time stamp counter.
+ *
+ * @returns Current 64-bit TSC value.
+ */
+static inline uint64_t tsc_read(void)
+{
+    uint32_t low;
+    uint32_t high;
+    __asm__ volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
+/**
+ * Report the TSC frequency in kHz, calibrating against PIT channel 2 on first use.
+ *
+ * @returns TSC ticks per millisecond, or `0` if calibration failed.
+ */
+uint32_t tsc_khz(void);
+
+/**
+ * Report whether CPUID advertises an invariant TSC.
+ *
+ * @returns `true` if the TSC rate is independent of power states.
+ */
+bool tsc_invariant(void);
+
+/**
+ * Report whether the TSC is trustworthy as a clocksource (invariant, or running under a hypervisor).
+ *
+ * @returns `true` if clock_ns() may be derived from the TSC.
+ */
+bool tsc_constant_rate(void);
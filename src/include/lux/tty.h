@@ -13,6 +13,7 @@ struct tty_cell {
     uint8_t color;
 };
 
+void tty_set_video_mode(void);
 void tty_init(uint8_t color);
 void tty_set_color(uint8_t color);
 void tty_putc(char c);
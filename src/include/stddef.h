@@ -5,8 +5,9 @@
  */
 #pragma once
 
-typedef unsigned int size_t;
-typedef int ptrdiff_t;
+/* Follow the compiler's ABI so the allocator also builds for the host benchmark. */
+typedef __SIZE_TYPE__ size_t;
+typedef __PTRDIFF_TYPE__ ptrdiff_t;
 
 typedef unsigned int wchar_t;
 
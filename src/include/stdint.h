@@ -17,5 +17,5 @@ typedef unsigned int uint32_t;
 typedef signed long long int64_t;
 typedef unsigned long long uint64_t;
 
-typedef int32_t intptr_t;
-typedef uint32_t uintptr_t;
\ No newline at end of file
+typedef __INTPTR_TYPE__ intptr_t;
+typedef __UINTPTR_TYPE__ uintptr_t;
\ No newline at end of file
@@ -0,0 +1,574 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Local APIC and IOAPIC setup from the ACPI MADT, MMIO EOIs, and the LAPIC timer.
+ */
+#include <lux/apic.h>
+#include <lux/cpu.h>
+#include <lux/irq.h>
+#include <lux/paging.h>
+#include <lux/tsc.h>
+#include <string.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define APIC_BASE_ENABLE 0x800u
+
+/* Local APIC registers (byte offsets from the MMIO base). */
+#define LAPIC_ID            0x020u
+#define LAPIC_TPR           0x080u
+#define LAPIC_EOI           0x0B0u
+#define LAPIC_SVR           0x0F0u
+#define LAPIC_IRR           0x200u
+#define LAPIC_LVT_TIMER     0x320u
+#define LAPIC_LVT_LINT0     0x350u
+#define LAPIC_TIMER_INITIAL 0x380u
+#define LAPIC_TIMER_CURRENT 0x390u
+#define LAPIC_TIMER_DIVIDE  0x3E0u
+
+#define LAPIC_SVR_ENABLE     0x100u
+#define LAPIC_LVT_MASKED     0x10000u
+#define LAPIC_TIMER_PERIODIC 0x20000u
+#define LAPIC_TIMER_DIV_16   0x3u
+
+/* IOAPIC indirect registers. */
+#define IOAPIC_REGSEL   0x00u
+#define IOAPIC_WINDOW   0x10u
+#define IOAPIC_VERSION  0x01u
+#define IOAPIC_REDIR    0x10u
+
+#define IOAPIC_ACTIVE_LOW 0x2000u
+#define IOAPIC_LEVEL      0x8000u
+#define IOAPIC_MASKED     0x10000u
+
+#define BDA_EBDA_SEGMENT 0x40Eu /* BIOS data area word holding the EBDA segment */
+
+#define APIC_MAX_IOAPICS 4u
+#define APIC_MMIO_SIZE   0x1000u
+
+/* Length of the calibration window for the LAPIC timer. */
+#define APIC_TIMER_CALIBRATE_MS 10u
+
+/* MADT interrupt controller structure types and interrupt source override flags. */
+#define MADT_IOAPIC          1u
+#define MADT_OVERRIDE        2u
+#define MADT_LAPIC_OVERRIDE  5u
+#define MPS_POLARITY_MASK    0x3u
+#define MPS_POLARITY_LOW     0x3u
+#define MPS_TRIGGER_MASK     0xCu
+#define MPS_TRIGGER_LEVEL    0xCu
+
+struct acpi_rsdp {
+    char signature[8];
+    uint8_t checksum;
+    char oem_id[6];
+    uint8_t revision;
+    uint32_t rsdt;
+    uint32_t length;
+    uint64_t xsdt;
+    uint8_t extended_checksum;
+    uint8_t reserved[3];
+} __attribute__((packed));
+
+struct acpi_header {
+    char signature[4];
+    uint32_t length;
+    uint8_t revision;
+    uint8_t checksum;
+    char oem_id[6];
+    char oem_table_id[8];
+    uint32_t oem_revision;
+    uint32_t creator_id;
+    uint32_t creator_revision;
+} __attribute__((packed));
+
+struct acpi_madt {
+    struct acpi_header header;
+    uint32_t lapic_address;
+    uint32_t flags;
+} __attribute__((packed));
+
+struct madt_ioapic {
+    uint8_t type;
+    uint8_t length;
+    uint8_t id;
+    uint8_t reserved;
+    uint32_t address;
+    uint32_t gsi_base;
+} __attribute__((packed));
+
+struct madt_override {
+    uint8_t type;
+    uint8_t length;
+    uint8_t bus;
+    uint8_t source;
+    uint32_t gsi;
+    uint16_t flags;
+} __attribute__((packed));
+
+struct madt_lapic_override {
+    uint8_t type;
+    uint8_t length;
+    uint16_t reserved;
+    uint64_t address;
+} __attribute__((packed));
+
+struct ioapic {
+    volatile uint32_t *mmio;
+    uint32_t gsi_base;
+    uint32_t pins;
+};
+
+static volatile uint32_t *lapic;
+static struct ioapic ioapics[APIC_MAX_IOAPICS];
+static size_t ioapic_count;
+static uint32_t irq_gsi[IRQ_LINES];
+static uint32_t irq_redirection[IRQ_LINES]; /* low dword without the mask bit; 0 if unrouted */
+static uint8_t bsp_apic_id;
+static bool apic_active;
+static bool apic_timer_running;
+static uint32_t apic_timer_period;  /* initial count of the periodic tick */
+static uint32_t apic_timer_per_ms;  /* timer counts per millisecond at the divide-by-16 setting */
+
+/**
+ * Read a local APIC register.
+ *
+ * @param reg Register offset.
+ * @returns Register value.
+ */
+static uint32_t lapic_read(uint32_t reg)
+{
+    return lapic[reg / 4u];
+}
+
+/**
+ * Write a local APIC register.
+ *
+ * @param reg Register offset.
+ * @param value Value to store.
+ */
+static void lapic_write(uint32_t reg, uint32_t value)
+{
+    lapic[reg / 4u] = value;
+}
+
+/**
+ * Read an IOAPIC register through its select/window pair.
+ *
+ * @param io IOAPIC to access.
+ * @param reg Register index.
+ * @returns Register value.
+ */
+static uint32_t ioapic_read(const struct ioapic *io, uint32_t reg)
+{
+    io->mmio[IOAPIC_REGSEL / 4u] = reg;
+    return io->mmio[IOAPIC_WINDOW / 4u];
+}
+
+/**
+ * Write an IOAPIC register through its select/window pair.
+ *
+ * @param io IOAPIC to access.
+ * @param reg Register index.
+ * @param value Value to store.
+ */
+static void ioapic_write(const struct ioapic *io, uint32_t reg, uint32_t value)
+{
+    io->mmio[IOAPIC_REGSEL / 4u] = reg;
+    io->mmio[IOAPIC_WINDOW / 4u] = value;
+}
+
+/**
+ * Find the IOAPIC that owns a global system interrupt.
+ *
+ * @param gsi Global system interrupt number.
+ * @param pin Receives the pin on that IOAPIC.
+ * @returns The IOAPIC, or NULL if no IOAPIC covers `gsi`.
+ */
+static const struct ioapic *ioapic_for_gsi(uint32_t gsi, uint32_t *pin)
+{
+    for (size_t i = 0; i < ioapic_count; ++i) {
+        if (gsi >= ioapics[i].gsi_base && gsi - ioapics[i].gsi_base < ioapics[i].pins) {
+            *pin = gsi - ioapics[i].gsi_base;
+            return &ioapics[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Verify an ACPI checksum (all bytes sum to zero).
+ *
+ * @param data Start of the structure.
+ * @param length Number of bytes covered by the checksum.
+ * @returns `true` if the checksum matches.
+ */
+static bool acpi_checksum_ok(const void *data, size_t length)
+{
+    const uint8_t *bytes = data;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < length; ++i) {
+        sum = (uint8_t)(sum + bytes[i]);
+    }
+    return sum == 0;
+}
+
+/**
+ * Scan a physical range on 16-byte boundaries for the ACPI root pointer.
+ *
+ * @param start First address to check.
+ * @param length Number of bytes to scan.
+ * @returns The RSDP, or NULL if none with a valid checksum was found.
+ */
+static const struct acpi_rsdp *acpi_scan_rsdp(uintptr_t start, size_t length)
+{
+    for (uintptr_t addr = start; addr + 20u <= start + length; addr += 16u) {
+        const struct acpi_rsdp *rsdp = (const struct acpi_rsdp *)addr;
+        if (memcmp(rsdp->signature, "RSD PTR ", 8) == 0 && acpi_checksum_ok(rsdp, 20u)) {
+            return rsdp;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Locate an ACPI table by signature through the XSDT or RSDT.
+ *
+ * The RSDP is searched in the first KiB of the EBDA and in the BIOS area
+ * 0xE0000-0xFFFFF; tables above 4 GiB are ignored.
+ *
+ * @param signature Four-character table signature.
+ * @returns The table header, or NULL if the table is absent or corrupt.
+ */
+static const struct acpi_header *acpi_find_table(const char *signature)
+{
+    uintptr_t segment_addr = BDA_EBDA_SEGMENT;
+    __asm__("" : "+r"(segment_addr)); /* hide the constant address from GCC's -Warray-bounds */
+    uintptr_t ebda = (uintptr_t)(*(const volatile uint16_t *)segment_addr) << 4;
+    const struct acpi_rsdp *rsdp = ebda ? acpi_scan_rsdp(ebda, 1024u) : NULL;
+    if (!rsdp) {
+        rsdp = acpi_scan_rsdp(0xE0000u, 0x20000u);
+    }
+    if (!rsdp) {
+        return NULL;
+    }
+
+    bool extended = rsdp->revision >= 2u && rsdp->xsdt && rsdp->xsdt < 0x100000000ull;
+    const struct acpi_header *root = extended ? (const struct acpi_header *)(uintptr_t)rsdp->xsdt
+                                              : (const struct acpi_header *)(uintptr_t)rsdp->rsdt;
+    if (!root || !acpi_checksum_ok(root, root->length)) {
+        return NULL;
+    }
+
+    size_t entry_size = extended ? 8u : 4u;
+    size_t entries = (root->length - sizeof(*root)) / entry_size;
+    const uint8_t *table = (const uint8_t *)(root + 1);
+    for (size_t i = 0; i < entries; ++i) {
+        uint64_t addr = 0;
+        memcpy(&addr, table + i * entry_size, entry_size);
+        if (!addr || addr >= 0x100000000ull) {
+            continue;
+        }
+        const struct acpi_header *header = (const struct acpi_header *)(uintptr_t)addr;
+        if (memcmp(header->signature, signature, 4) == 0 && acpi_checksum_ok(header, header->length)) {
+            return header;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Collect the LAPIC address, the IOAPICs, and the ISA interrupt source overrides from the MADT.
+ *
+ * @param madt Validated MADT.
+ * @param lapic_base Receives the local APIC MMIO address.
+ * @param irq_flags Receives the MPS INTI flags of each ISA IRQ (0 = bus default).
+ */
+static void apic_parse_madt(const struct acpi_madt *madt, uint64_t *lapic_base, uint16_t *irq_flags)
+{
+    *lapic_base = madt->lapic_address;
+    for (uint32_t irq = 0; irq < IRQ_LINES; ++irq) {
+        irq_gsi[irq] = irq;
+        irq_flags[irq] = 0;
+    }
+
+    const uint8_t *entry = (const uint8_t *)(madt + 1);
+    const uint8_t *end = (const uint8_t *)madt + madt->header.length;
+    while (entry + 2 <= end && entry[1] >= 2u && entry + entry[1] <= end) {
+        if (entry[0] == MADT_IOAPIC && entry[1] >= sizeof(struct madt_ioapic) && ioapic_count < APIC_MAX_IOAPICS) {
+            const struct madt_ioapic *io = (const struct madt_ioapic *)entry;
+            ioapics[ioapic_count].mmio = (volatile uint32_t *)(uintptr_t)io->address;
+            ioapics[ioapic_count].gsi_base = io->gsi_base;
+            ++ioapic_count;
+        } else if (entry[0] == MADT_OVERRIDE && entry[1] >= sizeof(struct madt_override)) {
+            const struct madt_override *override = (const struct madt_override *)entry;
+            if (override->bus == 0 && override->source < IRQ_LINES) {
+                irq_gsi[override->source] = override->gsi;
+                irq_flags[override->source] = override->flags;
+            }
+        } else if (entry[0] == MADT_LAPIC_OVERRIDE && entry[1] >= sizeof(struct madt_lapic_override)) {
+            const struct madt_lapic_override *override = (const struct madt_lapic_override *)entry;
+            *lapic_base = override->address;
+        }
+        entry += entry[1];
+    }
+}
+
+/**
+ * Map an APIC register page uncached.
+ *
+ * @param base Physical MMIO address.
+ * @returns `true` if the page is usable for MMIO.
+ */
+static bool apic_map_mmio(uint64_t base)
+{
+    if (base >= 0x100000000ull) {
+        return false;
+    }
+    return !paging_enabled() || paging_set_cache((uintptr_t)base, APIC_MMIO_SIZE, PAGING_CACHE_UNCACHED);
+}
+
+/**
+ * Route the ISA IRQs through the IOAPICs and enable the local APIC.
+ *
+ * Every IOAPIC pin starts masked; ISA IRQ n is sent to vector
+ * IRQ_VECTOR_BASE + n on the boot CPU, honouring the MADT's source overrides,
+ * and unmasked by apic_set_masked(). The caller masks the 8259s.
+ *
+ * @returns `true` if the APICs are in use, `false` if the CPU or firmware lacks them (the PIC stays in charge).
+ */
+bool apic_init(void)
+{
+    if (apic_active) {
+        return true;
+    }
+    if (!cpu_has_cpuid()) {
+        return false;
+    }
+
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    if ((edx & (CPUID_1_EDX_APIC | CPUID_1_EDX_MSR)) != (CPUID_1_EDX_APIC | CPUID_1_EDX_MSR)) {
+        return false;
+    }
+
+    const struct acpi_madt *madt = (const struct acpi_madt *)acpi_find_table("APIC");
+    if (!madt || madt->header.length < sizeof(*madt)) {
+        return false;
+    }
+
+    uint64_t lapic_base;
+    uint16_t irq_flags[IRQ_LINES];
+    ioapic_count = 0;
+    apic_parse_madt(madt, &lapic_base, irq_flags);
+    if (!ioapic_count || !apic_map_mmio(lapic_base)) {
+        return false;
+    }
+    for (size_t i = 0; i < ioapic_count; ++i) {
+        if (!apic_map_mmio((uintptr_t)ioapics[i].mmio)) {
+            return false;
+        }
+        ioapics[i].pins = ((ioapic_read(&ioapics[i], IOAPIC_VERSION) >> 16) & 0xFFu) + 1u;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    lapic = (volatile uint32_t *)(uintptr_t)lapic_base;
+    uint64_t base_msr = rdmsr(MSR_IA32_APIC_BASE);
+    wrmsr(MSR_IA32_APIC_BASE, (base_msr & 0xFFFull) | (lapic_base & ~0xFFFull) | APIC_BASE_ENABLE);
+    lapic_write(LAPIC_TPR, 0);
+    lapic_write(LAPIC_LVT_LINT0, LAPIC_LVT_MASKED); /* the 8259s stay masked */
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+    bsp_apic_id = (uint8_t)(lapic_read(LAPIC_ID) >> 24);
+
+    for (size_t i = 0; i < ioapic_count; ++i) {
+        for (uint32_t pin = 0; pin < ioapics[i].pins; ++pin) {
+            ioapic_write(&ioapics[i], IOAPIC_REDIR + pin * 2u, IOAPIC_MASKED);
+        }
+    }
+
+    for (uint32_t irq = 0; irq < IRQ_LINES; ++irq) {
+        uint32_t pin;
+        const struct ioapic *io = ioapic_for_gsi(irq_gsi[irq], &pin);
+        irq_redirection[irq] = 0;
+        if (irq == IRQ_CASCADE || !io) {
+            continue;
+        }
+        uint32_t low = IRQ_VECTOR_BASE + irq;
+        if ((irq_flags[irq] & MPS_POLARITY_MASK) == MPS_POLARITY_LOW) {
+            low |= IOAPIC_ACTIVE_LOW;
+        }
+        if ((irq_flags[irq] & MPS_TRIGGER_MASK) == MPS_TRIGGER_LEVEL) {
+            low |= IOAPIC_LEVEL;
+        }
+        irq_redirection[irq] = low;
+        ioapic_write(io, IOAPIC_REDIR + pin * 2u + 1u, (uint32_t)bsp_apic_id << 24);
+        ioapic_write(io, IOAPIC_REDIR + pin * 2u, low | IOAPIC_MASKED);
+    }
+
+    apic_active = true;
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Report whether interrupts are delivered through the APICs.
+ *
+ * @returns `true` after a successful apic_init().
+ */
+bool apic_enabled(void)
+{
+    return apic_active;
+}
+
+/**
+ * Signal end of interrupt to the local APIC: a single MMIO store.
+ */
+void apic_eoi(void)
+{
+    lapic_write(LAPIC_EOI, 0);
+}
+
+/**
+ * Mask or unmask the source behind an ISA IRQ line.
+ *
+ * IRQ0 controls the LAPIC timer once apic_timer_start() took over the tick;
+ * every other line controls its IOAPIC pin.
+ *
+ * @param irq ISA IRQ line (0-15).
+ * @param masked `true` to mask, `false` to unmask.
+ * @returns `true` on success, `false` if the APICs are off or the line is not routed.
+ */
+bool apic_set_masked(unsigned int irq, bool masked)
+{
+    if (!apic_active || irq >= IRQ_LINES) {
+        return false;
+    }
+
+    if (irq == IRQ_TIMER && apic_timer_running) {
+        uint32_t lvt = lapic_read(LAPIC_LVT_TIMER);
+        lapic_write(LAPIC_LVT_TIMER, masked ? (lvt | LAPIC_LVT_MASKED) : (lvt & ~LAPIC_LVT_MASKED));
+        return true;
+    }
+
+    uint32_t pin;
+    const struct ioapic *io = ioapic_for_gsi(irq_gsi[irq], &pin);
+    if (!io || !irq_redirection[irq]) {
+        return false;
+    }
+    ioapic_write(io, IOAPIC_REDIR + pin * 2u, irq_redirection[irq] | (masked ? IOAPIC_MASKED : 0u));
+    return true;
+}
+
+/**
+ * Report whether an IRQ is latched in the local APIC but not yet serviced.
+ *
+ * @param irq ISA IRQ line (0-15).
+ * @returns `true` if the line's vector is set in the LAPIC IRR.
+ */
+bool apic_irq_pending(unsigned int irq)
+{
+    if (!apic_active || irq >= IRQ_LINES) {
+        return false;
+    }
+    uint32_t vector = IRQ_VECTOR_BASE + irq;
+    return (lapic_read(LAPIC_IRR + (vector / 32u) * 0x10u) & (1u << (vector % 32u))) != 0;
+}
+
+/**
+ * Replace the PIT tick on IRQ0 with the periodic LAPIC timer.
+ *
+ * The timer is calibrated against the TSC over APIC_TIMER_CALIBRATE_MS and
+ * delivered on IRQ0's vector, so the IRQ0 handler keeps working unchanged; the
+ * PIT's IOAPIC pin is masked.
+ *
+ * @param hz Interrupt rate.
+ * @returns `true` if the LAPIC timer now drives IRQ0, `false` if the APICs are off or the TSC is uncalibrated.
+ */
+bool apic_timer_start(uint32_t hz)
+{
+    uint32_t khz = tsc_khz();
+    if (!apic_active || !hz || !khz) {
+        return false;
+    }
+
+    lapic_write(LAPIC_TIMER_DIVIDE, LAPIC_TIMER_DIV_16);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED | (IRQ_VECTOR_BASE + IRQ_TIMER));
+    lapic_write(LAPIC_TIMER_INITIAL, 0xFFFFFFFFu);
+    uint64_t start = tsc_read();
+    while (tsc_read() - start < (uint64_t)khz * APIC_TIMER_CALIBRATE_MS) {
+        __asm__ volatile("pause");
+    }
+    uint32_t elapsed = 0xFFFFFFFFu - lapic_read(LAPIC_TIMER_CURRENT);
+    uint32_t period = (uint32_t)(((uint64_t)elapsed * (1000u / APIC_TIMER_CALIBRATE_MS)) / hz);
+    if (!period) {
+        lapic_write(LAPIC_TIMER_INITIAL, 0);
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    apic_set_masked(IRQ_TIMER, true); /* the PIT's pin */
+    apic_timer_running = true;
+    apic_timer_period = period;
+    apic_timer_per_ms = elapsed / APIC_TIMER_CALIBRATE_MS;
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_TIMER_PERIODIC | (IRQ_VECTOR_BASE + IRQ_TIMER));
+    lapic_write(LAPIC_TIMER_INITIAL, period);
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Report whether the LAPIC timer drives IRQ0.
+ *
+ * @returns `true` after a successful apic_timer_start().
+ */
+bool apic_timer_active(void)
+{
+    return apic_timer_running;
+}
+
+/**
+ * Switch the LAPIC timer to one-shot mode and fire IRQ0 once after `ns`.
+ *
+ * Used by the tickless idle path; apic_timer_periodic() restores the tick.
+ * Call with interrupts disabled.
+ *
+ * @param ns Delay in nanoseconds; clamped to at least one timer count and to the 32-bit counter range.
+ * @returns `true` if the one-shot is armed, `false` if the LAPIC timer does not drive IRQ0.
+ */
+bool apic_timer_oneshot(uint64_t ns)
+{
+    if (!apic_timer_running || !apic_timer_per_ms) {
+        return false;
+    }
+
+    uint64_t ms = ns / 1000000u;
+    uint64_t count = ms * apic_timer_per_ms + ((ns % 1000000u) * apic_timer_per_ms) / 1000000u;
+    if (!count) {
+        count = 1;
+    } else if (count > 0xFFFFFFFFull) {
+        count = 0xFFFFFFFFull;
+    }
+
+    uint32_t masked = lapic_read(LAPIC_LVT_TIMER) & LAPIC_LVT_MASKED;
+    lapic_write(LAPIC_LVT_TIMER, masked | (IRQ_VECTOR_BASE + IRQ_TIMER));
+    lapic_write(LAPIC_TIMER_INITIAL, (uint32_t)count);
+    return true;
+}
+
+/**
+ * Return the LAPIC timer to the periodic tick programmed by apic_timer_start().
+ * Call with interrupts disabled.
+ */
+void apic_timer_periodic(void)
+{
+    if (!apic_timer_running) {
+        return;
+    }
+
+    uint32_t masked = lapic_read(LAPIC_LVT_TIMER) & LAPIC_LVT_MASKED;
+    lapic_write(LAPIC_LVT_TIMER, masked | LAPIC_TIMER_PERIODIC | (IRQ_VECTOR_BASE + IRQ_TIMER));
+    lapic_write(LAPIC_TIMER_INITIAL, apic_timer_period);
+}
@@ -0,0 +1,334 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Normalizes boot-sector (E820) and Multiboot 1/2 boot information into struct boot_info.
+ */
+#include <lux/boot.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MB1_INFO_MEMORY      (1u << 0)
+#define MB1_INFO_MMAP        (1u << 6)
+#define MB1_INFO_FRAMEBUFFER (1u << 12)
+
+#define MB2_TAG_END          0u
+#define MB2_TAG_BASIC_MEMINFO 4u
+#define MB2_TAG_MMAP         6u
+#define MB2_TAG_FRAMEBUFFER  8u
+
+struct mb1_info {
+    uint32_t flags;
+    uint32_t mem_lower;
+    uint32_t mem_upper;
+    uint32_t boot_device;
+    uint32_t cmdline;
+    uint32_t mods_count;
+    uint32_t mods_addr;
+    uint32_t syms[4];
+    uint32_t mmap_length;
+    uint32_t mmap_addr;
+    uint32_t drives_length;
+    uint32_t drives_addr;
+    uint32_t config_table;
+    uint32_t boot_loader_name;
+    uint32_t apm_table;
+    uint32_t vbe_control_info;
+    uint32_t vbe_mode_info;
+    uint16_t vbe_mode;
+    uint16_t vbe_interface_seg;
+    uint16_t vbe_interface_off;
+    uint16_t vbe_interface_len;
+    uint64_t framebuffer_addr;
+    uint32_t framebuffer_pitch;
+    uint32_t framebuffer_width;
+    uint32_t framebuffer_height;
+    uint8_t framebuffer_bpp;
+    uint8_t framebuffer_type;
+} __attribute__((packed));
+
+struct mb1_mmap_entry {
+    uint32_t size; /* size of the rest of the entry, excluding this field */
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+} __attribute__((packed));
+
+struct mb2_tag {
+    uint32_t type;
+    uint32_t size;
+} __attribute__((packed));
+
+struct mb2_tag_meminfo {
+    struct mb2_tag tag;
+    uint32_t mem_lower;
+    uint32_t mem_upper;
+} __attribute__((packed));
+
+struct mb2_tag_mmap {
+    struct mb2_tag tag;
+    uint32_t entry_size;
+    uint32_t entry_version;
+} __attribute__((packed));
+
+struct mb2_mmap_entry {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+    uint32_t reserved;
+} __attribute__((packed));
+
+struct mb2_tag_framebuffer {
+    struct mb2_tag tag;
+    uint64_t addr;
+    uint32_t pitch;
+    uint32_t width;
+    uint32_t height;
+    uint8_t bpp;
+    uint8_t type;
+} __attribute__((packed));
+
+static struct boot_info info;
+
+/**
+ * Append a region to the normalized memory map, dropping it if the table is full.
+ *
+ * @param base Physical start address of the region.
+ * @param length Region length in bytes; empty regions are skipped.
+ * @param type Region type using the E820 numbering.
+ */
+static void boot_info_add_region(uint64_t base, uint64_t length, uint32_t type)
+{
+    if (!length || info.mmap_count >= BOOT_MMAP_MAX) {
+        return;
+    }
+
+    struct boot_mmap_entry *entry = &info.mmap[info.mmap_count++];
+    entry->base = base;
+    entry->length = length;
+    entry->type = type;
+}
+
+/**
+ * Import the E820 map the boot sector left in the handoff block.
+ *
+ * @param handoff Handoff block passed by boot.asm in EBX.
+ */
+static void boot_info_parse_handoff(const struct boot_handoff *handoff)
+{
+    uint32_t count = handoff->e820_count;
+    if (count > BOOT_E820_MAX) {
+        count = BOOT_E820_MAX;
+    }
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const struct boot_e820_entry *entry = &handoff->e820[i];
+        boot_info_add_region(entry->base, entry->length, entry->type);
+    }
+}
+
+/**
+ * Sort the memory map by base address; firmware tables are not guaranteed to be ordered.
+ */
+static void boot_info_sort_mmap(void)
+{
+    for (size_t i = 1; i < info.mmap_count; ++i) {
+        struct boot_mmap_entry entry = info.mmap[i];
+        size_t j = i;
+        while (j && info.mmap[j - 1].base > entry.base) {
+            info.mmap[j] = info.mmap[j - 1];
+            --j;
+        }
+        info.mmap[j] = entry;
+    }
+}
+
+/**
+ * Import a Multiboot 1 information structure.
+ *
+ * @param mbi Information structure passed by the loader in EBX.
+ */
+static void boot_info_parse_mb1(const struct mb1_info *mbi)
+{
+    if (mbi->flags & MB1_INFO_MEMORY) {
+        info.has_meminfo = true;
+        info.mem_lower_kb = mbi->mem_lower;
+        info.mem_upper_kb = mbi->mem_upper;
+    }
+
+    if (mbi->flags & MB1_INFO_MMAP) {
+        uintptr_t cursor = mbi->mmap_addr;
+        uintptr_t end = cursor + mbi->mmap_length;
+        while (cursor + sizeof(struct mb1_mmap_entry) <= end) {
+            const struct mb1_mmap_entry *entry = (const struct mb1_mmap_entry *)cursor;
+            boot_info_add_region(entry->base, entry->length, entry->type);
+            cursor += entry->size + sizeof(entry->size);
+        }
+    }
+
+    if (mbi->flags & MB1_INFO_FRAMEBUFFER) {
+        info.has_framebuffer = true;
+        info.framebuffer.addr = mbi->framebuffer_addr;
+        info.framebuffer.pitch = mbi->framebuffer_pitch;
+        info.framebuffer.width = mbi->framebuffer_width;
+        info.framebuffer.height = mbi->framebuffer_height;
+        info.framebuffer.bpp = mbi->framebuffer_bpp;
+        info.framebuffer.type = mbi->framebuffer_type;
+    }
+}
+
+/**
+ * Import a Multiboot 2 tag list.
+ *
+ * @param data Start of the boot information (total_size, reserved, then 8-byte aligned tags).
+ */
+static void boot_info_parse_mb2(const uint8_t *data)
+{
+    uint32_t total_size = *(const uint32_t *)data;
+    const uint8_t *end = data + total_size;
+    const uint8_t *cursor = data + 8;
+
+    while (cursor + sizeof(struct mb2_tag) <= end) {
+        const struct mb2_tag *tag = (const struct mb2_tag *)cursor;
+        if (tag->type == MB2_TAG_END || tag->size < sizeof(struct mb2_tag)) {
+            break;
+        }
+
+        if (tag->type == MB2_TAG_BASIC_MEMINFO) {
+            const struct mb2_tag_meminfo *mem = (const struct mb2_tag_meminfo *)tag;
+            info.has_meminfo = true;
+            info.mem_lower_kb = mem->mem_lower;
+            info.mem_upper_kb = mem->mem_upper;
+        } else if (tag->type == MB2_TAG_MMAP) {
+            const struct mb2_tag_mmap *mmap = (const struct mb2_tag_mmap *)tag;
+            const uint8_t *entry_cursor = cursor + sizeof(*mmap);
+            const uint8_t *entry_end = cursor + tag->size;
+            while (mmap->entry_size && entry_cursor + sizeof(struct mb2_mmap_entry) <= entry_end) {
+                const struct mb2_mmap_entry *entry = (const struct mb2_mmap_entry *)entry_cursor;
+                boot_info_add_region(entry->base, entry->length, entry->type);
+                entry_cursor += mmap->entry_size;
+            }
+        } else if (tag->type == MB2_TAG_FRAMEBUFFER) {
+            const struct mb2_tag_framebuffer *fb = (const struct mb2_tag_framebuffer *)tag;
+            info.has_framebuffer = true;
+            info.framebuffer.addr = fb->addr;
+            info.framebuffer.pitch = fb->pitch;
+            info.framebuffer.width = fb->width;
+            info.framebuffer.height = fb->height;
+            info.framebuffer.bpp = fb->bpp;
+            info.framebuffer.type = fb->type;
+        }
+
+        cursor += (tag->size + 7u) & ~7u;
+    }
+}
+
+/**
+ * Capture the loader's boot information into the kernel's boot_info record.
+ *
+ * Must run before anything reuses the memory the loader left its data in.
+ *
+ * @param magic Loader identification passed in EAX.
+ * @param data Loader-specific boot data passed in EBX.
+ */
+void boot_info_init(uint32_t magic, const void *data)
+{
+    memset(&info, 0, sizeof(info));
+
+    switch (magic) {
+    case BOOT_HANDOFF_MAGIC:
+        info.loader = BOOT_LOADER_LUX;
+        if (data) {
+            boot_info_parse_handoff((const struct boot_handoff *)data);
+        }
+        break;
+    case MULTIBOOT1_BOOT_MAGIC:
+        info.loader = BOOT_LOADER_MULTIBOOT1;
+        if (data) {
+            boot_info_parse_mb1((const struct mb1_info *)data);
+        }
+        break;
+    case MULTIBOOT2_BOOT_MAGIC:
+        info.loader = BOOT_LOADER_MULTIBOOT2;
+        if (data) {
+            boot_info_parse_mb2((const uint8_t *)data);
+        }
+        break;
+    default:
+        info.loader = BOOT_LOADER_UNKNOWN;
+        break;
+    }
+
+    boot_info_sort_mmap();
+}
+
+/**
+ * Access the normalized boot information.
+ *
+ * @returns Pointer to the record filled by boot_info_init().
+ */
+const struct boot_info *boot_info_get(void)
+{
+    return &info;
+}
+
+/**
+ * Sum the lengths of all available regions in the memory map.
+ *
+ * @returns Usable RAM in bytes, or 0 when the loader provided no memory map.
+ */
+uint64_t boot_info_available_bytes(void)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < info.mmap_count; ++i) {
+        if (info.mmap[i].type == BOOT_MMAP_AVAILABLE) {
+            total += info.mmap[i].length;
+        }
+    }
+    return total;
+}
+
+/**
+ * Describe a loader for diagnostics.
+ *
+ * @param loader Loader identifier.
+ * @returns Static, human-readable loader name.
+ */
+const char *boot_loader_name(enum boot_loader loader)
+{
+    switch (loader) {
+    case BOOT_LOADER_LUX:
+        return "boot sector";
+    case BOOT_LOADER_MULTIBOOT1:
+        return "multiboot";
+    case BOOT_LOADER_MULTIBOOT2:
+        return "multiboot2";
+    default:
+        return "unknown";
+    }
+}
+
+/**
+ * Describe a memory map region type for diagnostics.
+ *
+ * @param type Region type using the E820 numbering.
+ * @returns Static, human-readable type name.
+ */
+const char *boot_mmap_type_name(uint32_t type)
+{
+    switch (type) {
+    case BOOT_MMAP_AVAILABLE:
+        return "available";
+    case BOOT_MMAP_RESERVED:
+        return "reserved";
+    case BOOT_MMAP_ACPI_RECLAIMABLE:
+        return "ACPI reclaimable";
+    case BOOT_MMAP_ACPI_NVS:
+        return "ACPI NVS";
+    case BOOT_MMAP_BAD:
+        return "bad";
+    default:
+        return "unknown";
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Boot-phase timestamp record fed by the loader, entry stub, and kernel().
+ */
+#include <lux/boottime.h>
+#include <lux/time.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Written by _start in entry.asm before .bss is cleared. */
+extern uint64_t boot_entry_tsc;
+
+static uint64_t phase_tsc[BOOT_PHASE_COUNT];
+static bool phase_valid[BOOT_PHASE_COUNT];
+
+static const char *const phase_names[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_LOADER_START] = "loader",
+    [BOOT_PHASE_LOADER_JUMP]  = "disk load",
+    [BOOT_PHASE_ENTRY]        = "entry",
+    [BOOT_PHASE_HEAP_INIT]    = "heap_init",
+    [BOOT_PHASE_TTY_INIT]     = "tty_init",
+    [BOOT_PHASE_IDT_INIT]     = "idt_init",
+    [BOOT_PHASE_ATA_INIT]     = "ata_pio_init",
+    [BOOT_PHASE_FS_MOUNT]     = "fs_mount",
+    [BOOT_PHASE_PROMPT]       = "first prompt",
+};
+
+/**
+ * Store a timestamp for a phase unless one has already been recorded.
+ *
+ * @param phase Phase to record.
+ * @param tsc TSC value to store.
+ */
+static void boottime_store(enum boot_phase phase, uint64_t tsc)
+{
+    if (phase >= BOOT_PHASE_COUNT || phase_valid[phase] || !tsc) {
+        return;
+    }
+    phase_tsc[phase] = tsc;
+    phase_valid[phase] = true;
+}
+
+/**
+ * Import the loader and entry-stub timestamps into the boot-time record.
+ *
+ * @param handoff Boot sector handoff block, or NULL when the kernel was started
+ *                by another loader (the loader phases are then left unrecorded).
+ */
+void boottime_init(const struct boot_handoff *handoff)
+{
+    if (handoff) {
+        boottime_store(BOOT_PHASE_LOADER_START, handoff->loader_start_tsc);
+        boottime_store(BOOT_PHASE_LOADER_JUMP, handoff->loader_jump_tsc);
+    }
+
+    boottime_store(BOOT_PHASE_ENTRY, boot_entry_tsc);
+}
+
+/**
+ * Record the current TSC as the completion time of `phase`.
+ *
+ * @param phase Phase that just finished.
+ */
+void boottime_mark(enum boot_phase phase)
+{
+    boottime_store(phase, clock_cycles());
+}
+
+/**
+ * Retrieve the timestamp recorded for a boot phase.
+ *
+ * @param phase Phase to query.
+ * @param tsc Receives the recorded TSC value when available; may be NULL.
+ * @returns `true` if the phase was recorded, `false` otherwise.
+ */
+bool boottime_get(enum boot_phase phase, uint64_t *tsc)
+{
+    if (phase >= BOOT_PHASE_COUNT || !phase_valid[phase]) {
+        return false;
+    }
+    if (tsc) {
+        *tsc = phase_tsc[phase];
+    }
+    return true;
+}
+
+/**
+ * Get the human-readable label for a boot phase.
+ *
+ * @param phase Phase to describe.
+ * @returns Static label string, or "?" for out-of-range values.
+ */
+const char *boottime_phase_name(enum boot_phase phase)
+{
+    if (phase >= BOOT_PHASE_COUNT) {
+        return "?";
+    }
+    return phase_names[phase];
+}
@@ -0,0 +1,259 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Event bus: per-type subscriber lists, synchronous raises, and a softirq-drained post queue.
+ */
+#include <lux/cpu.h>
+#include <lux/event.h>
+#include <lux/softirq.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct event_subscription {
+    event_handler_t handler; /* NULL while the slot is free */
+    void *context;
+    enum event_type type;
+    uint32_t serial;                      /* subscribe order; lets a running dispatch spot reused slots */
+    struct event_subscription *prev;
+    struct event_subscription *next;      /* kept when unlinked so a running dispatch can step past it */
+    struct event_subscription *next_free;
+};
+
+static struct event_subscription subscriptions[EVENT_MAX_SUBSCRIPTIONS];
+static struct event_subscription *subscribers[EVENT_TYPE_MAX];
+static struct event_subscription *free_subscriptions;
+static uint32_t subscribe_serial;
+
+static struct event queue[EVENT_QUEUE_CAPACITY];
+static size_t queue_head;
+static size_t queue_tail;
+static size_t queue_count;
+
+static uint64_t event_raised[EVENT_TYPE_MAX];
+static uint64_t event_dropped;
+static bool bus_ready;
+
+/**
+ * Deliver every queued event; runs as the event softirq with interrupts enabled.
+ *
+ * @param context Unused.
+ */
+static void event_softirq(void *context)
+{
+    (void)context;
+
+    for (;;) {
+        uint32_t flags = cpu_irq_save();
+        if (!queue_count) {
+            cpu_irq_restore(flags);
+            return;
+        }
+        struct event event = queue[queue_tail];
+        queue_tail = (queue_tail + 1u) % EVENT_QUEUE_CAPACITY;
+        --queue_count;
+        cpu_irq_restore(flags);
+
+        event_raise(event.type, event.data);
+    }
+}
+
+/**
+ * Set up the subscription pool and register the softirq that delivers posted events.
+ *
+ * Safe to call more than once; later calls have no effect.
+ */
+void event_bus_init(void)
+{
+    if (bus_ready) {
+        return;
+    }
+
+    free_subscriptions = NULL;
+    for (size_t i = EVENT_MAX_SUBSCRIPTIONS; i-- > 0;) {
+        subscriptions[i].handler = NULL;
+        subscriptions[i].next_free = free_subscriptions;
+        free_subscriptions = &subscriptions[i];
+    }
+    for (size_t type = 0; type < EVENT_TYPE_MAX; ++type) {
+        subscribers[type] = NULL;
+    }
+
+    softirq_register(SOFTIRQ_EVENT, event_softirq, NULL);
+    bus_ready = true;
+}
+
+/**
+ * Register a handler for one event type.
+ *
+ * Handlers run in task or softirq context with interrupts enabled, never inside
+ * an IRQ handler. A handler may unsubscribe itself.
+ *
+ * @param type Event type to subscribe to.
+ * @param handler Function to call for each event of that type; must be non-NULL.
+ * @param context Opaque pointer passed to the handler.
+ * @returns Subscription id (`0`..`EVENT_MAX_SUBSCRIPTIONS - 1`) on success, `-1` if the arguments are invalid or the pool is exhausted.
+ */
+int event_subscribe(enum event_type type, event_handler_t handler, void *context)
+{
+    if (!handler || type >= EVENT_TYPE_MAX) {
+        return -1;
+    }
+    event_bus_init();
+
+    uint32_t flags = cpu_irq_save();
+    struct event_subscription *sub = free_subscriptions;
+    if (!sub) {
+        cpu_irq_restore(flags);
+        return -1;
+    }
+    free_subscriptions = sub->next_free;
+
+    sub->handler = handler;
+    sub->context = context;
+    sub->type = type;
+    sub->serial = ++subscribe_serial;
+    sub->prev = NULL;
+    sub->next = subscribers[type];
+    if (sub->next) {
+        sub->next->prev = sub;
+    }
+    subscribers[type] = sub;
+    cpu_irq_restore(flags);
+    return (int)(sub - subscriptions);
+}
+
+/**
+ * Remove a subscription in constant time.
+ *
+ * @param id Value returned by event_subscribe().
+ * @returns `true` if the subscription existed and was removed, `false` otherwise.
+ */
+bool event_unsubscribe(int id)
+{
+    if (id < 0 || id >= (int)EVENT_MAX_SUBSCRIPTIONS) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    struct event_subscription *sub = &subscriptions[id];
+    if (!sub->handler) {
+        cpu_irq_restore(flags);
+        return false;
+    }
+
+    if (sub->prev) {
+        sub->prev->next = sub->next;
+    } else {
+        subscribers[sub->type] = sub->next;
+    }
+    if (sub->next) {
+        sub->next->prev = sub->prev;
+    }
+    sub->handler = NULL;
+    sub->context = NULL;
+    sub->next_free = free_subscriptions;
+    free_subscriptions = sub;
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Check whether anyone listens for an event type, so producers can skip building events nobody wants.
+ *
+ * @param type Event type to check.
+ * @returns `true` if the type has at least one subscriber.
+ */
+bool event_has_subscribers(enum event_type type)
+{
+    return type < EVENT_TYPE_MAX && subscribers[type] != NULL;
+}
+
+/**
+ * Deliver an event to the subscribers of its type right away.
+ *
+ * Only the subscribers of `type` are visited. Call from task or softirq
+ * context; interrupt handlers use event_post() instead.
+ *
+ * A handler may unsubscribe itself. If it removes the subscriber after it, that
+ * slot may be freed or reused for another type by the time the walk reaches it.
+ * The walk therefore stops at a free slot, a slot of another type, or a
+ * subscription made after this raise began. The remaining subscribers then miss
+ * this one event.
+ *
+ * @param type Event type.
+ * @param data Type-specific payload (see enum event_type).
+ */
+void event_raise(enum event_type type, uint32_t data)
+{
+    if (type >= EVENT_TYPE_MAX) {
+        return;
+    }
+
+    struct event event = {
+        .type = type,
+        .data = data
+    };
+
+    ++event_raised[type];
+    uint32_t serial = subscribe_serial;
+    struct event_subscription *sub = subscribers[type];
+    while (sub && sub->handler && sub->type == type && sub->serial <= serial) {
+        struct event_subscription *next = sub->next;
+        sub->handler(&event, sub->context);
+        sub = next;
+    }
+}
+
+/**
+ * Queue an event for delivery from the event softirq. Safe in any context, including IRQ handlers.
+ *
+ * Events without subscribers are discarded at once, so producers on hot paths
+ * such as the timer tick cost a single check while nobody listens.
+ *
+ * @param type Event type.
+ * @param data Type-specific payload (see enum event_type).
+ * @returns `true` if the event was queued or had no subscribers, `false` if the queue was full.
+ */
+bool event_post(enum event_type type, uint32_t data)
+{
+    if (!event_has_subscribers(type)) {
+        return true;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    if (queue_count >= EVENT_QUEUE_CAPACITY) {
+        ++event_dropped;
+        cpu_irq_restore(flags);
+        return false;
+    }
+    queue[queue_head].type = type;
+    queue[queue_head].data = data;
+    queue_head = (queue_head + 1u) % EVENT_QUEUE_CAPACITY;
+    ++queue_count;
+    softirq_raise(SOFTIRQ_EVENT);
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Copy the per-type delivery counters and the number of dropped posts.
+ *
+ * @param stats Structure to fill; must not be NULL.
+ * @returns `true` on success, `false` if `stats` is NULL.
+ */
+bool event_get_stats(struct event_stats *stats)
+{
+    if (!stats) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    for (size_t type = 0; type < EVENT_TYPE_MAX; ++type) {
+        stats->raised[type] = event_raised[type];
+    }
+    stats->dropped = event_dropped;
+    cpu_irq_restore(flags);
+    return true;
+}
@@ -0,0 +1,71 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: CPU idle path shared by every blocking wait, with idle-time accounting.
+ */
+#include <lux/cpu.h>
+#include <lux/idle.h>
+#include <lux/softirq.h>
+#include <lux/time.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+static uint64_t idle_cycles_total;
+static uint64_t idle_halts;
+static uint64_t idle_tickless;
+
+/**
+ * Halt the CPU until the next interrupt and account the time spent halted.
+ *
+ * Call with interrupts disabled after checking the wake-up condition: `sti`
+ * only takes effect after the following `hlt`, so an interrupt that arrives
+ * between the check and the halt still wakes the CPU. Returns with interrupts
+ * enabled, after the waking interrupt has been serviced.
+ *
+ * Bottom halves left pending by an interrupt flood run here instead of halting;
+ * the caller then rechecks its wake-up condition. When nothing needs the
+ * periodic tick, the halt lasts until the next timer deadline or device
+ * interrupt rather than the next tick (see clock_idle_enter()).
+ */
+void cpu_idle(void)
+{
+    if (softirq_pending()) {
+        softirq_run();
+        cpu_irq_enable();
+        return;
+    }
+
+    bool tickless = clock_idle_enter();
+    uint64_t start = clock_cycles();
+#ifdef LUX_IRQ_TRACE
+    irq_off_end(); /* the halt below re-enables interrupts */
+#endif
+    __asm__ volatile("sti; hlt" : : : "memory");
+    idle_cycles_total += clock_cycles() - start;
+    ++idle_halts;
+    if (tickless) {
+        clock_idle_exit();
+        ++idle_tickless;
+    }
+}
+
+/**
+ * Report how much time the CPU has spent in cpu_idle().
+ *
+ * @param stats Structure to fill; must not be NULL.
+ * @returns `true` on success, `false` if `stats` is NULL.
+ */
+bool idle_get_stats(struct idle_stats *stats)
+{
+    if (!stats) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    stats->idle_cycles = idle_cycles_total;
+    stats->halts = idle_halts;
+    stats->tickless = idle_tickless;
+    cpu_irq_restore(flags);
+    return true;
+}
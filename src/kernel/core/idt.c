@@ -3,25 +3,28 @@
  * Author: Lukas Fend <lukas.fend@outlook.com>
  * Description: IDT initialization and interrupt handler support for x86.
  */
+#include <lux/cpu.h>
 #include <lux/idt.h>
-#include <lux/keyboard.h>
-#include <lux/io.h>
+#include <lux/paging.h>
+#include <lux/printf.h>
 
 /**
- * Read the keyboard scancode from I/O port 0x60 and forward it to the keyboard driver for processing in interrupt context.
+ * Handle a page fault: demand-zero faults in the heap window are resolved, anything else halts the CPU.
  *
- * Invoked by the IRQ1 assembly handler.
+ * Invoked by the vector 0x0E assembly stub with interrupts disabled.
+ *
+ * @param error Error code pushed by the CPU.
+ * @param eip Address of the faulting instruction.
  */
-void keyboard_irq_handler_c(void)
+void page_fault_handler_c(uint32_t error, uint32_t eip)
 {
-    /* Read the scancode from the keyboard data port */
-    uint8_t scancode = inb(0x60);
-    
-    /* 
-     * Process the scancode using the existing keyboard driver functions.
-     * This allows the keyboard driver to maintain its current architecture
-     * while switching from polling to interrupt-driven.
-     */
-    char out_char;
-    (void)keyboard_process_scancode_irq(scancode, &out_char);
-}
\ No newline at end of file
+    uintptr_t addr = read_cr2();
+    if (paging_handle_fault(addr, error)) {
+        return;
+    }
+
+    kprintf("\n[fault] page fault at %p (eip %p, error %x); halting.\n", (void *)addr, (void *)(uintptr_t)eip, (unsigned int)error);
+    for (;;) {
+        __asm__ volatile("cli; hlt");
+    }
+}
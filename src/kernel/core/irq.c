@@ -0,0 +1,400 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: C side of the generated IRQ stubs: handler table, PIC or APIC masking, EOIs, counters, and latency statistics.
+ */
+#include <lux/apic.h>
+#include <lux/cpu.h>
+#include <lux/io.h>
+#include <lux/irq.h>
+#include <lux/softirq.h>
+#include <lux/time.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PIC1_CMD     0x20u
+#define PIC1_DATA    0x21u
+#define PIC2_CMD     0xA0u
+#define PIC2_DATA    0xA1u
+#define PIC_EOI      0x20u
+#define PIC_READ_IRR 0x0Au
+#define PIC_READ_ISR 0x0Bu
+
+struct irq_slot {
+    irq_handler_t handler;
+    void *context;
+};
+
+static struct irq_slot irq_slots[IRQ_LINES];
+static uint64_t irq_counts[IRQ_LINES];
+static uint64_t irq_spurious[IRQ_LINES];
+static uint64_t irq_cycles[IRQ_LINES];
+static uint32_t irq_max_cycles[IRQ_LINES];
+static uint32_t irq_histogram[IRQ_LINES][IRQ_HIST_BUCKETS];
+#ifdef LUX_IRQ_TRACE
+static uint64_t irq_off_start; /* 0 while no span is open */
+static uint32_t irq_off_site;
+#endif
+static uint64_t irq_off_max;
+static uint32_t irq_off_max_site;
+static const struct irq_frame *irq_frame_current;
+static bool irq_use_apic;
+
+/**
+ * Mask or unmask one line at the active interrupt controller, leaving the other lines untouched.
+ *
+ * @param irq Line number (0-15).
+ * @param masked `true` to mask the line, `false` to unmask it.
+ */
+static void irq_set_masked(unsigned int irq, bool masked)
+{
+    if (irq_use_apic) {
+        apic_set_masked(irq, masked);
+        return;
+    }
+
+    uint16_t port = irq < 8u ? PIC1_DATA : PIC2_DATA;
+    uint8_t bit = (uint8_t)(1u << (irq & 7u));
+    uint8_t mask = inb(port);
+    outb(port, masked ? (uint8_t)(mask | bit) : (uint8_t)(mask & ~bit));
+}
+
+/**
+ * Read a PIC's in-service or interrupt request register.
+ *
+ * @param command_port Command port of the PIC to query.
+ * @param ocw3 PIC_READ_ISR or PIC_READ_IRR.
+ * @returns Register bitmap; bit n refers to IRQ n of that PIC.
+ */
+static uint8_t irq_read_pic(uint16_t command_port, uint8_t ocw3)
+{
+    outb(command_port, ocw3);
+    return inb(command_port);
+}
+
+/**
+ * Move interrupt delivery from the 8259 PICs to the local APIC and IOAPIC when the firmware describes them.
+ *
+ * Call after idt_init() and before any irq_register(). On success both PICs are
+ * masked completely, EOIs become a single MMIO store, and lines are masked at
+ * the IOAPIC instead.
+ *
+ * @returns `true` if the APICs deliver interrupts, `false` if the PIC stays in use.
+ */
+bool irq_init(void)
+{
+    if (!apic_init()) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    outb(PIC1_DATA, 0xFFu);
+    outb(PIC2_DATA, 0xFFu);
+    irq_use_apic = true;
+    for (unsigned int irq = 0; irq < IRQ_LINES; ++irq) {
+        if (irq_slots[irq].handler) {
+            apic_set_masked(irq, false);
+        }
+    }
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Report which controller delivers interrupts.
+ *
+ * @returns "apic" or "pic".
+ */
+const char *irq_controller(void)
+{
+    return irq_use_apic ? "apic" : "pic";
+}
+
+/**
+ * Report whether a line has an interrupt latched but not yet serviced.
+ *
+ * @param irq Line number (0-15).
+ * @returns `true` if the request is pending at the interrupt controller.
+ */
+bool irq_pending(unsigned int irq)
+{
+    if (irq >= IRQ_LINES) {
+        return false;
+    }
+    if (irq_use_apic) {
+        return apic_irq_pending(irq);
+    }
+    uint16_t port = irq < 8u ? PIC1_CMD : PIC2_CMD;
+    return (irq_read_pic(port, PIC_READ_IRR) & (1u << (irq & 7u))) != 0;
+}
+
+/**
+ * Attach a handler to an IRQ line and unmask it.
+ *
+ * Handlers run in interrupt context with interrupts disabled; the EOI is sent
+ * after they return. Keep them short and defer the rest with softirq_raise().
+ * Each line takes one handler.
+ *
+ * @param irq Line number (0-15, except the IRQ2 cascade).
+ * @param handler Function to call for every interrupt on the line; must be non-NULL.
+ * @param context Opaque pointer passed to the handler.
+ * @returns `true` on success, `false` if the line is invalid, the cascade, or already taken.
+ */
+bool irq_register(unsigned int irq, irq_handler_t handler, void *context)
+{
+    if (irq >= IRQ_LINES || irq == IRQ_CASCADE || !handler) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    if (irq_slots[irq].handler) {
+        cpu_irq_restore(flags);
+        return false;
+    }
+    irq_slots[irq].handler = handler;
+    irq_slots[irq].context = context;
+    irq_set_masked(irq, false);
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Mask an IRQ line and detach its handler.
+ *
+ * @param irq Line number (0-15).
+ * @returns `true` if a handler was removed, `false` if the line is invalid or had none.
+ */
+bool irq_unregister(unsigned int irq)
+{
+    if (irq >= IRQ_LINES || irq == IRQ_CASCADE) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    bool registered = irq_slots[irq].handler != NULL;
+    irq_set_masked(irq, true);
+    irq_slots[irq].handler = NULL;
+    irq_slots[irq].context = NULL;
+    cpu_irq_restore(flags);
+    return registered;
+}
+
+/**
+ * Report how many interrupts a line has delivered to its handler.
+ *
+ * @param irq Line number (0-15).
+ * @returns Interrupt count, or `0` for an invalid line.
+ */
+uint64_t irq_count(unsigned int irq)
+{
+    if (irq >= IRQ_LINES) {
+        return 0;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    uint64_t count = irq_counts[irq];
+    cpu_irq_restore(flags);
+    return count;
+}
+
+/**
+ * Copy the per-line counters, handler time statistics, and the longest
+ * interrupts-disabled section.
+ *
+ * @param stats Structure to fill; must not be NULL.
+ * @returns `true` on success, `false` if `stats` is NULL.
+ */
+bool irq_get_stats(struct irq_stats *stats)
+{
+    if (!stats) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    for (size_t i = 0; i < IRQ_LINES; ++i) {
+        stats->counts[i] = irq_counts[i];
+        stats->spurious[i] = irq_spurious[i];
+        stats->cycles[i] = irq_cycles[i];
+        stats->max_cycles[i] = irq_max_cycles[i];
+        for (size_t bucket = 0; bucket < IRQ_HIST_BUCKETS; ++bucket) {
+            stats->histogram[i][bucket] = irq_histogram[i][bucket];
+        }
+        stats->handlers[i] = (uint32_t)(uintptr_t)irq_slots[i].handler;
+    }
+    stats->irqoff_max = irq_off_max;
+    stats->irqoff_site = irq_off_max_site;
+#ifdef LUX_IRQ_TRACE
+    stats->irqoff_traced = true;
+#else
+    stats->irqoff_traced = false;
+#endif
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Zero the counters, handler time statistics, and interrupts-disabled maximum,
+ * so a workload can be measured on its own.
+ */
+void irq_reset_stats(void)
+{
+    uint32_t flags = cpu_irq_save();
+    for (size_t i = 0; i < IRQ_LINES; ++i) {
+        irq_counts[i] = 0;
+        irq_spurious[i] = 0;
+        irq_cycles[i] = 0;
+        irq_max_cycles[i] = 0;
+        for (size_t bucket = 0; bucket < IRQ_HIST_BUCKETS; ++bucket) {
+            irq_histogram[i][bucket] = 0;
+        }
+    }
+    irq_off_max = 0;
+    irq_off_max_site = 0;
+    cpu_irq_restore(flags);
+}
+
+#ifdef LUX_IRQ_TRACE
+/**
+ * Start timing an interrupts-disabled section. Called by cpu_irq_save() and
+ * cpu_irq_disable() right after they cleared IF, so it must not use either itself.
+ *
+ * @param site Address inside the call site.
+ */
+void irq_off_begin(uint32_t site)
+{
+    irq_off_site = site;
+    irq_off_start = clock_cycles();
+}
+
+/**
+ * Finish the open section and keep it if it is the longest so far. Called right
+ * before IF is set again: by cpu_irq_restore(), cpu_irq_enable(), the idle
+ * halt, and at the end of irq_dispatch().
+ */
+void irq_off_end(void)
+{
+    if (!irq_off_start) {
+        return;
+    }
+    uint64_t span = clock_cycles() - irq_off_start;
+    irq_off_start = 0;
+    if (span > irq_off_max) {
+        irq_off_max = span;
+        irq_off_max_site = irq_off_site;
+    }
+}
+#endif
+
+/**
+ * Add one handler run to its line's time statistics.
+ *
+ * @param irq Line number (0-15).
+ * @param cycles clock_cycles() from dispatch entry to the EOI.
+ */
+static void irq_account(uint32_t irq, uint64_t cycles)
+{
+    uint32_t span = cycles > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)cycles;
+    uint32_t bits = span ? 32u - (uint32_t)__builtin_clz(span) : 0u;
+    uint32_t bucket = bits > IRQ_HIST_SHIFT + 1u ? bits - (IRQ_HIST_SHIFT + 1u) : 0u;
+    if (bucket >= IRQ_HIST_BUCKETS) {
+        bucket = IRQ_HIST_BUCKETS - 1u;
+    }
+
+    irq_cycles[irq] += span;
+    if (span > irq_max_cycles[irq]) {
+        irq_max_cycles[irq] = span;
+    }
+    ++irq_histogram[irq][bucket];
+}
+
+/**
+ * Give handlers access to the state of the code their interrupt preempted.
+ *
+ * @returns Frame of the IRQ being handled, or NULL outside hardware interrupt handlers.
+ */
+const struct irq_frame *irq_current_frame(void)
+{
+    return irq_frame_current;
+}
+
+/**
+ * Recognise a spurious PIC IRQ7/IRQ15: the line is not set in the in-service
+ * register. A spurious IRQ15 still owes the master an EOI for the cascade, which is sent here.
+ *
+ * @param irq Line number (0-15).
+ * @returns `true` if the interrupt is spurious and must not be acknowledged further.
+ */
+static bool irq_pic_spurious(uint32_t irq)
+{
+    if (irq == 7u && !(irq_read_pic(PIC1_CMD, PIC_READ_ISR) & 0x80u)) {
+        return true;
+    }
+    if (irq == 15u && !(irq_read_pic(PIC2_CMD, PIC_READ_ISR) & 0x80u)) {
+        outb(PIC1_CMD, PIC_EOI);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Dispatch an IRQ from the common assembly stub.
+ *
+ * With the PICs, spurious IRQ7/IRQ15 get no EOI (see irq_pic_spurious());
+ * otherwise the handler runs and the slave, then the master, is acknowledged.
+ * With the APICs the handler runs and the local APIC gets its EOI; its spurious
+ * vector never reaches this function.
+ * The time from entry to the EOI, during which interrupts stay disabled, goes
+ * into the line's histogram. Bottom halves the handler raised run last, with
+ * interrupts enabled, and are not counted. In IRQ_TRACE=1 builds the whole
+ * interrupts-off part of the dispatch is also traced, attributed to the handler.
+ *
+ * @param frame Registers saved by the stub; `frame->irq` is the line number (0-15).
+ */
+void irq_dispatch(struct irq_frame *frame)
+{
+    uint64_t start = clock_cycles();
+    uint32_t irq = frame->irq;
+    if (irq >= IRQ_LINES) {
+        return;
+    }
+#ifdef LUX_IRQ_TRACE
+    /* The interrupt gate cleared IF; the span ends at the softirq sti or right before iret. */
+    irq_off_start = start;
+    irq_off_site = irq_slots[irq].handler ? (uint32_t)(uintptr_t)irq_slots[irq].handler : cpu_irq_site();
+#endif
+
+    if (!irq_use_apic && irq_pic_spurious(irq)) {
+        ++irq_spurious[irq];
+    } else {
+        const struct irq_slot *slot = &irq_slots[irq];
+        if (slot->handler) {
+            const struct irq_frame *outer = irq_frame_current;
+            ++irq_counts[irq];
+            irq_frame_current = frame;
+            slot->handler((unsigned int)irq, slot->context);
+            irq_frame_current = outer;
+        } else {
+            ++irq_spurious[irq];
+        }
+
+        if (irq_use_apic) {
+            apic_eoi();
+        } else {
+            if (irq >= 8u) {
+                outb(PIC2_CMD, PIC_EOI);
+            }
+            outb(PIC1_CMD, PIC_EOI);
+        }
+        irq_account(irq, clock_cycles() - start);
+
+        if (softirq_pending()) {
+            softirq_run();
+        }
+    }
+
+#ifdef LUX_IRQ_TRACE
+    irq_off_end();
+#endif
+}
@@ -4,13 +4,22 @@
  * Description: Kernel entry point that initializes the TTY and launches the shell.
  */
 #include <stdbool.h>
+#include <stdint.h>
 
+#include <lux/apic.h>
 #include <lux/ata.h>
+#include <lux/boot.h>
+#include <lux/boottime.h>
+#include <lux/event.h>
 #include <lux/idt.h>
-#include <lux/interrupt.h>
+#include <lux/irq.h>
+#include <lux/keyboard.h>
 #include <lux/fs.h>
 #include <lux/memory.h>
+#include <lux/paging.h>
+#include <lux/printf.h>
 #include <lux/shell.h>
+#include <lux/time.h>
 #include <lux/tty.h>
 
 /**
@@ -26,29 +35,66 @@ static void banner(void)
 /**
  * Initialize core kernel subsystems, start the interactive shell, and halt the CPU if the shell exits.
  *
- * Performs early kernel setup (heap allocator, TTY, and interrupt dispatcher), attempts disk and
+ * Performs early kernel setup (page and heap allocators, identity paging, TTY, and interrupt dispatcher), attempts disk and
  * filesystem initialization (may continue without storage if those steps fail), displays the kernel
  * banner, and launches the shell. If the shell ever returns, the function enters an infinite halted loop.
+ * Each step is stamped into the boot-time record so `boottime` can report where startup time goes.
+ *
+ * @param boot_magic Loader identification passed in EAX by the loader.
+ * @param boot_data Loader-specific boot data passed in EBX (the boot handoff block for boot.asm,
+ *                  the multiboot information structure otherwise).
  */
-void kernel(void)
+void kernel(uint32_t boot_magic, const void *boot_data)
 {
+    boottime_init(boot_magic == BOOT_HANDOFF_MAGIC ? (const struct boot_handoff *)boot_data : 0);
+    boot_info_init(boot_magic, boot_data);
+    const struct boot_info *boot = boot_info_get();
+
+    page_alloc_init();
     heap_init();
+    bool paged = paging_init();
+    boottime_mark(BOOT_PHASE_HEAP_INIT);
+    if (boot->loader != BOOT_LOADER_LUX) {
+        /* Only the boot sector sets up VGA mode 12h through the BIOS. */
+        tty_set_video_mode();
+    }
     tty_init(0x1F);
-    interrupt_dispatcher_init();
+    boottime_mark(BOOT_PHASE_TTY_INIT);
+    event_bus_init();
     
-    /* Initialize the IDT and remap the PIC for interrupt-driven input */
+    /* Initialize the IDT and remap the PIC, switch to the APICs if present, then let the timer and keyboard claim their IRQs */
     idt_init();
+    if (paging_has_heap_window()) {
+        /* The page-fault handler is live, so the heap may now grow into unmapped memory. */
+        heap_add_window((void *)HEAP_WINDOW_BASE, HEAP_WINDOW_SIZE);
+    }
+    irq_init();
+    clock_init();
+    keyboard_init();
     interrupt_enable();
+    boottime_mark(BOOT_PHASE_IDT_INIT);
+
+    bool disk_ready = ata_pio_init();
+    boottime_mark(BOOT_PHASE_ATA_INIT);
 
-    if (!ata_pio_init()) {
+    if (!disk_ready) {
         tty_write_string("[disk] ATA PIO init failed; filesystem disabled.\n");
-    } else if (!fs_mount()) {
-        tty_write_string("[disk] Filesystem mount failed; continuing without storage.\n");
     } else {
-        tty_write_string("[disk] Filesystem mounted successfully.\n");
+        bool mounted = fs_mount();
+        boottime_mark(BOOT_PHASE_FS_MOUNT);
+        if (!mounted) {
+            tty_write_string("[disk] Filesystem mount failed; continuing without storage.\n");
+        } else {
+            tty_write_string("[disk] Filesystem mounted successfully.\n");
+        }
     }
 
     banner();
+    kprintf("[boot] %s, %u memory map entries\n", boot_loader_name(boot->loader), (unsigned int)boot->mmap_count);
+    kprintf("[boot] Interrupts via %s, %s timer tick\n", irq_controller(), apic_timer_active() ? "lapic" : "pit");
+    if (!paged) {
+        tty_write_string("[boot] No PSE support; running with paging disabled.\n");
+    }
     shell_run();
 
     for (;;)
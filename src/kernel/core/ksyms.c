@@ -0,0 +1,77 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Address-to-symbol lookups over the table tools/gen_ksyms.py links into the kernel.
+ */
+#include <lux/ksyms.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Find the function containing an address.
+ *
+ * @param addr Code address, e.g. a sampled EIP or return address.
+ * @returns Index into ksym_table, or `-1` if the address is outside every known symbol.
+ */
+int ksym_index(uint32_t addr)
+{
+    uint32_t low = 0;
+    uint32_t high = ksym_count;
+
+    /* Last entry whose start is <= addr. */
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2u;
+        if (ksym_table[mid].addr <= addr) {
+            low = mid + 1u;
+        } else {
+            high = mid;
+        }
+    }
+    if (!low) {
+        return -1;
+    }
+
+    const struct ksym *sym = &ksym_table[low - 1u];
+    if (sym->size && addr - sym->addr >= sym->size) {
+        return -1;
+    }
+    return (int)(low - 1u);
+}
+
+/**
+ * Return the name of a symbol table entry.
+ *
+ * @param index Value returned by ksym_index().
+ * @returns NUL-terminated name, or NULL if `index` is out of range.
+ */
+const char *ksym_name(int index)
+{
+    if (index < 0 || (uint32_t)index >= ksym_count) {
+        return NULL;
+    }
+    return &ksym_names[ksym_table[index].name];
+}
+
+/**
+ * Resolve an address to `symbol+offset`.
+ *
+ * @param addr Code address to resolve.
+ * @param name Receives the symbol name; must not be NULL.
+ * @param offset Optional; receives the distance from the symbol start.
+ * @returns `true` if the address falls inside a known symbol, `false` otherwise.
+ */
+bool ksym_lookup(uint32_t addr, const char **name, uint32_t *offset)
+{
+    int index = ksym_index(addr);
+    if (index < 0 || !name) {
+        return false;
+    }
+
+    *name = ksym_name(index);
+    if (offset) {
+        *offset = addr - ksym_table[index].addr;
+    }
+    return true;
+}
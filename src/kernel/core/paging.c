@@ -0,0 +1,309 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Identity-mapped 4 MiB PSE paging with PAT-based write-combining for video memory
+ *              and a demand-zero window for the kernel heap.
+ */
+#include <lux/boot.h>
+#include <lux/cpu.h>
+#include <lux/memory.h>
+#include <lux/paging.h>
+#include <string.h>
+
+#define PAGING_ENTRIES 1024u
+
+#define PTE_PRESENT  0x001u
+#define PTE_WRITABLE 0x002u
+#define PTE_PWT      0x008u
+#define PTE_PCD      0x010u
+#define PDE_LARGE    0x080u
+#define PTE_CACHE_MASK (PTE_PWT | PTE_PCD)
+#define PTE_ADDR_MASK  0xFFFFF000u
+
+/* Page-fault error code bits. */
+#define PF_PRESENT 0x001u
+
+/*
+ * PAT entries 0-7: WB, WC, UC-, UC, WB, WT, UC-, UC. Only PA1 differs from the
+ * power-on default (WT), so PWT alone selects write-combining while PCD|PWT
+ * still means uncached with or without PAT.
+ */
+#define PAT_VALUE 0x0007040600070106ull
+
+static uint32_t *page_directory;
+static bool paging_active;
+static bool pat_enabled;
+static bool heap_window_reserved;
+
+/**
+ * Translate a cache mode into the PWT/PCD bits of a page table or page directory entry.
+ *
+ * @param cache Requested cache mode.
+ * @returns Entry bits selecting the matching PAT slot.
+ */
+static uint32_t paging_cache_bits(enum paging_cache cache)
+{
+    switch (cache) {
+    case PAGING_CACHE_WRITE_COMBINING:
+        return pat_enabled ? PTE_PWT : (PTE_PCD | PTE_PWT);
+    case PAGING_CACHE_UNCACHED:
+        return PTE_PCD | PTE_PWT;
+    case PAGING_CACHE_WRITE_BACK:
+    default:
+        return 0;
+    }
+}
+
+/**
+ * Return the page table behind a page directory slot, replacing a 4 MiB mapping by 1024 equivalent 4 KiB pages first.
+ *
+ * @param index Page directory index.
+ * @returns The page table, or NULL if the slot is unmapped or no table could be allocated.
+ */
+static uint32_t *paging_split_large(size_t index)
+{
+    uint32_t pde = page_directory[index];
+    if (!(pde & PTE_PRESENT)) {
+        return NULL;
+    }
+    if (!(pde & PDE_LARGE)) {
+        return (uint32_t *)(uintptr_t)(pde & PTE_ADDR_MASK);
+    }
+
+    uint32_t *table = aligned_alloc(PAGE_SIZE, PAGE_SIZE);
+    if (!table) {
+        return NULL;
+    }
+
+    uint32_t base = pde & ~(PAGING_LARGE_PAGE_SIZE - 1u);
+    uint32_t flags = (pde & PTE_CACHE_MASK) | PTE_WRITABLE | PTE_PRESENT;
+    for (size_t i = 0; i < PAGING_ENTRIES; ++i) {
+        table[i] = (base + (uint32_t)(i * PAGE_SIZE)) | flags;
+    }
+    page_directory[index] = (uint32_t)(uintptr_t)table | PTE_WRITABLE | PTE_PRESENT;
+    return table;
+}
+
+/**
+ * Change the caching of an identity-mapped physical range.
+ *
+ * Whole, aligned 4 MiB spans keep their large page; partial spans are split into
+ * 4 KiB pages. The TLB is flushed if paging is already on.
+ *
+ * @param base Physical start address; rounded down to a page boundary.
+ * @param length Range length in bytes; the end is rounded up to a page boundary.
+ * @param cache Cache mode to apply.
+ * @returns `true` on success, `false` if paging is not set up, the range is empty or beyond 4 GiB,
+ *          the range touches the heap window, or a page table could not be allocated.
+ */
+bool paging_set_cache(uintptr_t base, size_t length, enum paging_cache cache)
+{
+    if (!page_directory || length == 0) {
+        return false;
+    }
+
+    uint64_t start = (uint64_t)base & ~(uint64_t)(PAGE_SIZE - 1u);
+    uint64_t end = ((uint64_t)base + length + PAGE_SIZE - 1u) & ~(uint64_t)(PAGE_SIZE - 1u);
+    if (end > 0x100000000ull) {
+        return false;
+    }
+
+    uint32_t bits = paging_cache_bits(cache);
+    while (start < end) {
+        size_t index = (size_t)(start >> 22);
+        if ((page_directory[index] & PDE_LARGE) && (start & (PAGING_LARGE_PAGE_SIZE - 1u)) == 0
+            && end - start >= PAGING_LARGE_PAGE_SIZE) {
+            page_directory[index] = (page_directory[index] & ~PTE_CACHE_MASK) | bits;
+            start += PAGING_LARGE_PAGE_SIZE;
+            continue;
+        }
+
+        uint32_t *table = paging_split_large(index);
+        if (!table) {
+            return false;
+        }
+        size_t slot = (size_t)(start >> 12) & (PAGING_ENTRIES - 1u);
+        table[slot] = (table[slot] & ~PTE_CACHE_MASK) | bits;
+        start += PAGE_SIZE;
+    }
+
+    if (paging_active) {
+        write_cr3((uint32_t)(uintptr_t)page_directory);
+    }
+    return true;
+}
+
+/**
+ * Check whether the heap window covers nothing but unused addresses or RAM above the managed limit.
+ *
+ * Demand-zero faults would otherwise hide whatever the firmware put there:
+ * ACPI tables (common on guests with 2-2.25 GiB of RAM), reserved ranges, MMIO,
+ * or the loader's framebuffer.
+ *
+ * @param boot Normalized boot information.
+ * @returns `true` if the window may be unmapped and served on demand.
+ */
+static bool paging_heap_window_unused(const struct boot_info *boot)
+{
+    const uint64_t window_start = HEAP_WINDOW_BASE;
+    const uint64_t window_end = (uint64_t)HEAP_WINDOW_BASE + HEAP_WINDOW_SIZE;
+
+    if (boot->has_framebuffer) {
+        uint64_t fb_start = boot->framebuffer.addr;
+        uint64_t fb_end = fb_start + (uint64_t)boot->framebuffer.pitch * boot->framebuffer.height;
+        if (fb_end > window_start && fb_start < window_end) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < boot->mmap_count; ++i) {
+        const struct boot_mmap_entry *region = &boot->mmap[i];
+        if (region->type == BOOT_MMAP_AVAILABLE) {
+            continue;
+        }
+        if (region->base + region->length > window_start && region->base < window_end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Identity-map the 4 GiB physical address space with 4 MiB pages and enable paging.
+ *
+ * Everything defaults to write-back so the MTRRs keep deciding the memory type of RAM and MMIO;
+ * the VGA aperture and the loader's linear framebuffer (if any) are mapped write-combining when
+ * the CPU supports PAT and uncached otherwise. The heap window is left unmapped for
+ * paging_handle_fault() only if the memory map and framebuffer leave it unused (see
+ * paging_heap_window_unused()); otherwise it stays identity-mapped and the heap grows from
+ * page allocator arenas instead. Must run after heap_init(), which backs the tables.
+ *
+ * @returns `true` if paging is enabled, `false` if the CPU lacks PSE or the tables could not be allocated.
+ */
+bool paging_init(void)
+{
+    if (paging_active) {
+        return true;
+    }
+    if (!cpu_has_cpuid()) {
+        return false;
+    }
+
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(1, 0, &eax, &ebx, &ecx, &edx);
+    if (!(edx & CPUID_1_EDX_PSE)) {
+        return false;
+    }
+
+    page_directory = aligned_alloc(PAGE_SIZE, PAGE_SIZE);
+    if (!page_directory) {
+        return false;
+    }
+    for (uint32_t i = 0; i < PAGING_ENTRIES; ++i) {
+        page_directory[i] = (i * PAGING_LARGE_PAGE_SIZE) | PDE_LARGE | PTE_WRITABLE | PTE_PRESENT;
+    }
+
+    const struct boot_info *boot = boot_info_get();
+    if (paging_heap_window_unused(boot)) {
+        /* Unmapped until touched; paging_handle_fault() fills it with zeroed frames. */
+        for (uint32_t i = 0; i < HEAP_WINDOW_SIZE / PAGING_LARGE_PAGE_SIZE; ++i) {
+            page_directory[HEAP_WINDOW_BASE / PAGING_LARGE_PAGE_SIZE + i] = 0;
+        }
+        heap_window_reserved = true;
+    }
+
+    if ((edx & CPUID_1_EDX_PAT) && (edx & CPUID_1_EDX_MSR)) {
+        wrmsr(MSR_IA32_PAT, PAT_VALUE);
+        pat_enabled = true;
+    }
+
+    /* The VGA window shares the first 4 MiB with the kernel, so it ends up on 4 KiB pages. */
+    paging_set_cache(VGA_APERTURE_BASE, VGA_APERTURE_SIZE, PAGING_CACHE_WRITE_COMBINING);
+
+    if (boot->has_framebuffer && boot->framebuffer.type != 2 && boot->framebuffer.addr < 0x100000000ull) {
+        uint64_t size = (uint64_t)boot->framebuffer.pitch * boot->framebuffer.height;
+        if (size > 0 && boot->framebuffer.addr + size <= 0x100000000ull) {
+            paging_set_cache((uintptr_t)boot->framebuffer.addr, (size_t)size, PAGING_CACHE_WRITE_COMBINING);
+        }
+    }
+
+    write_cr4(read_cr4() | CR4_PSE);
+    write_cr3((uint32_t)(uintptr_t)page_directory);
+    write_cr0(read_cr0() | CR0_PG);
+    paging_active = true;
+    return true;
+}
+
+/**
+ * Report whether paging has been enabled.
+ *
+ * @returns `true` once paging_init() succeeded.
+ */
+bool paging_enabled(void)
+{
+    return paging_active;
+}
+
+/**
+ * Report whether the PAT was programmed, i.e. whether write-combining mappings are real.
+ *
+ * @returns `true` if PAT entry 1 selects write-combining.
+ */
+bool paging_has_pat(void)
+{
+    return pat_enabled;
+}
+
+/**
+ * Report whether the heap window (HEAP_WINDOW_BASE, HEAP_WINDOW_SIZE) is unmapped and served on demand.
+ *
+ * @returns `true` if heap_add_window() may be pointed at the window once the page-fault handler is installed.
+ */
+bool paging_has_heap_window(void)
+{
+    return heap_window_reserved;
+}
+
+/**
+ * Resolve a page fault by mapping a zeroed frame into the heap window.
+ *
+ * The frame, and the page table when the window's 4 MiB slot has none yet,
+ * come out of the frames the heap reserved when it committed that part of the
+ * window. Faults outside the window, on pages that are already present, or on
+ * pages the heap never committed are not handled.
+ *
+ * @param addr Faulting linear address (CR2).
+ * @param error Error code pushed by the CPU.
+ * @returns `true` if the access can be retried, `false` if the fault is fatal.
+ */
+bool paging_handle_fault(uintptr_t addr, uint32_t error)
+{
+    if (!heap_window_reserved || (error & PF_PRESENT)
+        || addr < HEAP_WINDOW_BASE || addr - HEAP_WINDOW_BASE >= HEAP_WINDOW_SIZE
+        || !heap_window_committed(addr)) {
+        return false;
+    }
+
+    size_t index = addr >> 22;
+    uint32_t *table;
+    if (page_directory[index] & PTE_PRESENT) {
+        table = (uint32_t *)(uintptr_t)(page_directory[index] & PTE_ADDR_MASK);
+    } else {
+        table = page_alloc_reserved();
+        if (!table) {
+            return false;
+        }
+        memset(table, 0, PAGE_SIZE);
+        page_directory[index] = (uint32_t)(uintptr_t)table | PTE_WRITABLE | PTE_PRESENT;
+    }
+
+    void *frame = page_alloc_reserved();
+    if (!frame) {
+        return false;
+    }
+    memset(frame, 0, PAGE_SIZE);
+
+    /* Not-present entries are never cached in the TLB, so no invalidation is needed. */
+    table[(addr >> 12) & (PAGING_ENTRIES - 1u)] = (uint32_t)(uintptr_t)frame | PTE_WRITABLE | PTE_PRESENT;
+    return true;
+}
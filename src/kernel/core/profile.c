@@ -0,0 +1,255 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Timer-driven EIP sampler with an optional frame-pointer stack and per-symbol aggregation.
+ */
+#include <lux/cpu.h>
+#include <lux/ksyms.h>
+#include <lux/memory.h>
+#include <lux/profile.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROFILE_STACK_TOP 0x00200000u /* boot stack set up by entry.asm */
+
+static struct profile_sample *profile_buffer;
+static uint32_t profile_head;
+static uint32_t profile_stored;
+static uint64_t profile_samples;
+static uint32_t profile_period = 1u;
+static uint32_t profile_countdown;
+static volatile bool profile_running;
+
+/**
+ * Record the return addresses of the interrupted code's callers.
+ *
+ * Follows saved EBP links only while they stay inside the boot stack, are
+ * aligned, and move towards its top, so a function that uses EBP as a general
+ * register ends the walk instead of faulting.
+ *
+ * @param frame Registers of the interrupted code.
+ * @param callers Receives up to PROFILE_STACK_DEPTH return addresses; unused slots are zeroed.
+ */
+static void profile_walk_stack(const struct irq_frame *frame, uint32_t *callers)
+{
+    size_t depth = 0;
+#ifdef LUX_PROFILE_FRAMES
+    uint32_t low = (uint32_t)(uintptr_t)(&frame->eflags + 1);
+    uint32_t ebp = frame->ebp;
+    while (depth < PROFILE_STACK_DEPTH) {
+        if (ebp < low || ebp > PROFILE_STACK_TOP - 8u || (ebp & 3u)) {
+            break;
+        }
+        const uint32_t *link = (const uint32_t *)(uintptr_t)ebp;
+        if (!link[1]) {
+            break;
+        }
+        callers[depth++] = link[1];
+        low = ebp + 8u;
+        ebp = link[0];
+    }
+#else
+    (void)frame;
+#endif
+    while (depth < PROFILE_STACK_DEPTH) {
+        callers[depth++] = 0;
+    }
+}
+
+/**
+ * Start (or resume) sampling; the ring is allocated on first use.
+ *
+ * @param period_ticks Take one sample every this many timer ticks; 0 is treated as 1.
+ * @returns `true` if sampling is running, `false` if the sample ring could not be allocated.
+ */
+bool profile_start(uint32_t period_ticks)
+{
+    if (!profile_buffer) {
+        profile_buffer = malloc(PROFILE_SAMPLES * sizeof(*profile_buffer));
+        if (!profile_buffer) {
+            return false;
+        }
+    }
+
+    uint32_t flags = cpu_irq_save();
+    profile_period = period_ticks ? period_ticks : 1u;
+    profile_countdown = 0;
+    profile_running = true;
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Stop sampling; recorded samples stay available to profile_top().
+ */
+void profile_stop(void)
+{
+    profile_running = false;
+}
+
+/**
+ * Report whether samples are being taken; the tickless idle path keeps the tick while they are.
+ *
+ * @returns `true` between profile_start() and profile_stop().
+ */
+bool profile_active(void)
+{
+    return profile_running;
+}
+
+/**
+ * Discard every recorded sample.
+ */
+void profile_reset(void)
+{
+    uint32_t flags = cpu_irq_save();
+    profile_head = 0;
+    profile_stored = 0;
+    profile_samples = 0;
+    profile_countdown = 0;
+    cpu_irq_restore(flags);
+}
+
+/**
+ * Take a sample if the profiler is running and the period has elapsed.
+ *
+ * Called from the timer interrupt; costs one branch while the profiler is
+ * stopped and a bounded stack walk while it runs.
+ *
+ * @param frame Registers of the interrupted code, or NULL outside an IRQ.
+ */
+void profile_tick(const struct irq_frame *frame)
+{
+    if (!profile_running || !frame) {
+        return;
+    }
+    if (++profile_countdown < profile_period) {
+        return;
+    }
+    profile_countdown = 0;
+
+    struct profile_sample *sample = &profile_buffer[profile_head];
+    sample->eip = frame->eip;
+    profile_walk_stack(frame, sample->callers);
+
+    profile_head = (profile_head + 1u) % PROFILE_SAMPLES;
+    if (profile_stored < PROFILE_SAMPLES) {
+        ++profile_stored;
+    }
+    ++profile_samples;
+}
+
+/**
+ * Report the sampler state.
+ *
+ * @param stats Structure to fill; must not be NULL.
+ * @returns `true` on success, `false` if `stats` is NULL.
+ */
+bool profile_get_stats(struct profile_stats *stats)
+{
+    if (!stats) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    stats->samples = profile_samples;
+    stats->stored = profile_stored;
+    stats->period = profile_period;
+    stats->running = profile_running;
+    cpu_irq_restore(flags);
+#ifdef LUX_PROFILE_FRAMES
+    stats->frames = true;
+#else
+    stats->frames = false;
+#endif
+    return true;
+}
+
+/**
+ * Aggregate the recorded samples per symbol and return the hottest ones.
+ *
+ * Sampling is paused while the ring is read. Entries are ordered by self
+ * samples, highest first; `total` additionally counts samples in which the
+ * symbol appears as a caller (only in PROFILE_FRAMES=1 builds).
+ *
+ * @param entries Output array; must hold `max_entries` entries.
+ * @param max_entries Maximum number of symbols to report.
+ * @returns Number of entries written; `0` if nothing was sampled or memory ran out.
+ */
+size_t profile_top(struct profile_entry *entries, size_t max_entries)
+{
+    if (!entries || !max_entries || !profile_stored) {
+        return 0;
+    }
+
+    /* One counter pair per symbol plus a trailing bucket for unknown addresses. */
+    size_t buckets = (size_t)ksym_count + 1u;
+    uint32_t *self = calloc(buckets, sizeof(*self));
+    uint32_t *total = calloc(buckets, sizeof(*total));
+    if (!self || !total) {
+        free(self);
+        free(total);
+        return 0;
+    }
+
+    bool was_running = profile_running;
+    profile_running = false;
+
+    for (uint32_t i = 0; i < profile_stored; ++i) {
+        const struct profile_sample *sample = &profile_buffer[i];
+        int seen[PROFILE_STACK_DEPTH + 1u];
+        size_t seen_count = 0;
+
+        for (size_t level = 0; level <= PROFILE_STACK_DEPTH; ++level) {
+            uint32_t addr = level ? sample->callers[level - 1u] : sample->eip;
+            if (level && !addr) {
+                break;
+            }
+            /* Return addresses point past the call; look up the call itself. */
+            int symbol = ksym_index(level ? addr - 1u : addr);
+            size_t bucket = symbol < 0 ? buckets - 1u : (size_t)symbol;
+            if (!level) {
+                ++self[bucket];
+            }
+
+            bool counted = false;
+            for (size_t k = 0; k < seen_count; ++k) {
+                if (seen[k] == symbol) {
+                    counted = true;
+                    break;
+                }
+            }
+            if (!counted) {
+                seen[seen_count++] = symbol;
+                ++total[bucket];
+            }
+        }
+    }
+
+    profile_running = was_running;
+
+    /* Selection of the hottest buckets; max_entries is small. */
+    size_t found = 0;
+    while (found < max_entries) {
+        size_t best = buckets;
+        for (size_t b = 0; b < buckets; ++b) {
+            if (self[b] && (best == buckets || self[b] > self[best])) {
+                best = b;
+            }
+        }
+        if (best == buckets) {
+            break;
+        }
+        entries[found].symbol = best == buckets - 1u ? -1 : (int)best;
+        entries[found].self = self[best];
+        entries[found].total = total[best];
+        self[best] = 0;
+        ++found;
+    }
+
+    free(self);
+    free(total);
+    return found;
+}
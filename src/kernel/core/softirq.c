@@ -0,0 +1,111 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Bottom halves: IRQ handlers raise them, irq_dispatch() and the idle path run them.
+ */
+#include <lux/cpu.h>
+#include <lux/softirq.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Passes over the pending mask per softirq_run(); the rest waits for the next IRQ exit or idle. */
+#define SOFTIRQ_MAX_RESTART 4u
+
+struct softirq_slot {
+    softirq_handler_t handler;
+    void *context;
+};
+
+static struct softirq_slot softirq_slots[SOFTIRQ_LINES];
+static volatile uint32_t softirq_mask;
+static bool softirq_active;
+
+/**
+ * Attach the handler for a softirq line.
+ *
+ * @param nr Softirq number (`0`..`SOFTIRQ_LINES - 1`).
+ * @param handler Function run with interrupts enabled after the line is raised; must be non-NULL.
+ * @param context Opaque pointer passed to the handler.
+ * @returns `true` on success, `false` if `nr` is invalid, `handler` is NULL, or the line is taken.
+ */
+bool softirq_register(unsigned int nr, softirq_handler_t handler, void *context)
+{
+    if (nr >= SOFTIRQ_LINES || !handler) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    if (softirq_slots[nr].handler) {
+        cpu_irq_restore(flags);
+        return false;
+    }
+    softirq_slots[nr].handler = handler;
+    softirq_slots[nr].context = context;
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Mark a softirq as pending. Safe to call from interrupt context.
+ *
+ * @param nr Softirq number; invalid numbers are ignored.
+ */
+void softirq_raise(unsigned int nr)
+{
+    if (nr >= SOFTIRQ_LINES) {
+        return;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    softirq_mask |= 1u << nr;
+    cpu_irq_restore(flags);
+}
+
+/**
+ * Report whether any softirq is waiting to run.
+ *
+ * @returns `true` if at least one line has been raised and not yet handled.
+ */
+bool softirq_pending(void)
+{
+    return softirq_mask != 0;
+}
+
+/**
+ * Run pending softirq handlers with interrupts enabled.
+ *
+ * Called on IRQ exit (after the EOI) and from the idle path. Handlers never
+ * nest: an IRQ that arrives while they run only raises its line, and the loop
+ * here picks it up. After SOFTIRQ_MAX_RESTART passes the remaining work is left
+ * pending so a flood cannot starve the interrupted code. Returns with the
+ * interrupt flag as the caller had it.
+ */
+void softirq_run(void)
+{
+    uint32_t flags = cpu_irq_save();
+    if (softirq_active) {
+        cpu_irq_restore(flags);
+        return;
+    }
+    softirq_active = true;
+
+    for (uint32_t pass = 0; pass < SOFTIRQ_MAX_RESTART && softirq_mask; ++pass) {
+        uint32_t pending = softirq_mask;
+        softirq_mask = 0;
+        cpu_irq_enable();
+
+        for (unsigned int nr = 0; pending; ++nr, pending >>= 1) {
+            const struct softirq_slot *slot = &softirq_slots[nr];
+            if ((pending & 1u) && slot->handler) {
+                slot->handler(slot->context);
+            }
+        }
+
+        cpu_irq_disable();
+    }
+
+    softirq_active = false;
+    cpu_irq_restore(flags);
+}
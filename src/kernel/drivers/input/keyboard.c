@@ -1,11 +1,16 @@
 /*
  * Date: 2025-12-10 00:00 UTC
  * Author: Lukas Fend <lukas.fend@outlook.com>
- * Description: PS/2 keyboard driver that polls scancodes and returns characters.
+ * Description: PS/2 keyboard driver that queues IRQ1 scancodes as key events and returns characters.
  */
-#include <lux/interrupt.h>
+#include <lux/cpu.h>
+#include <lux/idle.h>
+#include <lux/event.h>
+#include <lux/irq.h>
 #include <lux/keyboard.h>
 #include <lux/io.h>
+#include <lux/ring.h>
+#include <lux/softirq.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -150,6 +155,13 @@ static size_t event_head;
 static size_t event_tail;
 static size_t event_count;
 
+/* Raw scancodes from IRQ1, translated later by the keyboard softirq. */
+#define KEYBOARD_SCANCODE_CAPACITY 64u
+static uint8_t scancode_buffer[KEYBOARD_SCANCODE_CAPACITY];
+static struct ring scancode_ring;
+
+static void keyboard_softirq(void *context);
+
 /**
  * Determine whether a character is an ASCII letter or one of the supported German umlaut letters (ä, Ä, ö, Ö, ü, Ü).
  * @param c Character to test.
@@ -313,8 +325,10 @@ static uint8_t keyboard_current_modifiers(void)
  *
  * If `symbol` is 0, no event is queued. When the queue is full, the oldest
  * event is dropped to make room for the new one. The queued event captures
- * the current modifier bitfield and marks the key as pressed. If `symbol`
- * is ASCII 0x03 (ETX), the function also raises the CTRL-C interrupt.
+ * the current modifier bitfield and marks the key as pressed. Subscribers of
+ * EVENT_KEY are notified, and if `symbol` is ASCII 0x03 (ETX) so are those of
+ * EVENT_CTRL_C.
+ * Runs from the keyboard softirq, so the queue update masks interrupts itself.
  *
  * @param symbol The translated symbol to enqueue (must be non-zero to be queued).
  */
@@ -330,6 +344,7 @@ static void keyboard_queue_event(char symbol)
         .pressed = true
     };
 
+    uint32_t flags = cpu_irq_save();
     if (event_count >= KEYBOARD_EVENT_CAPACITY) {
         event_tail = (event_tail + 1u) % KEYBOARD_EVENT_CAPACITY;
         --event_count;
@@ -338,9 +353,11 @@ static void keyboard_queue_event(char symbol)
     event_queue[event_head] = event;
     event_head = (event_head + 1u) % KEYBOARD_EVENT_CAPACITY;
     ++event_count;
+    cpu_irq_restore(flags);
 
+    event_raise(EVENT_KEY, (uint32_t)(uint8_t)symbol | (uint32_t)event.modifiers << 8);
     if ((unsigned char)symbol == 0x03u) {
-        interrupt_raise(INTERRUPT_SIGNAL_CTRL_C);
+        event_raise(EVENT_CTRL_C, 0);
     }
 }
 
@@ -513,18 +530,23 @@ static bool keyboard_scan_symbol(char *out_char)
 }
 
 /**
- * Attempt to poll the keyboard and produce a translated character without blocking.
+ * Attempt to take a translated character from the event queue without blocking.
  *
  * @param out_char Pointer to a char that will be set to the translated character when available.
  * @return `true` if a character was produced and written to `out_char`, `false` otherwise.
  */
 bool keyboard_poll_char(char *out_char)
 {
-    return keyboard_scan_symbol(out_char);
+    struct keyboard_event event;
+    if (!out_char || !keyboard_poll_event(&event)) {
+        return false;
+    }
+    *out_char = event.symbol;
+    return true;
 }
 
 /**
- * Read the next translated character from the keyboard, waiting until one is available.
+ * Read the next translated character from the keyboard, idling until one is available.
  *
  * @returns The next translated character produced by the keyboard (respecting current layout and active modifiers).
  */
@@ -532,13 +554,18 @@ char keyboard_read_char(void)
 {
     char result;
     while (!keyboard_poll_char(&result)) {
-        continue;
+        keyboard_wait();
     }
     return result;
 }
 
 /**
- * Polls for the next keyboard event and writes it to the provided output if one is available.
+ * Dequeues the next keyboard event and writes it to the provided output if one is available.
+ *
+ * Events are queued by the keyboard softirq. While interrupts are disabled (early
+ * boot) scancodes already in the ring are translated here and the controller is
+ * drained by polling instead, so callers work either way.
+ *
  * @param event Pointer to a caller-provided struct keyboard_event to receive the dequeued event; must not be NULL.
  * @returns `true` if an event was dequeued and written to `event`, `false` otherwise (including when `event` is NULL or the queue is empty).
  */
@@ -548,9 +575,16 @@ bool keyboard_poll_event(struct keyboard_event *event)
         return false;
     }
 
-    char unused;
-    (void)keyboard_scan_symbol(&unused);
-    return keyboard_dequeue_event(event);
+    if (!cpu_interrupts_enabled()) {
+        char unused;
+        keyboard_softirq(NULL);
+        (void)keyboard_scan_symbol(&unused);
+    }
+
+    uint32_t flags = cpu_irq_save();
+    bool dequeued = keyboard_dequeue_event(event);
+    cpu_irq_restore(flags);
+    return dequeued;
 }
 
 /**
@@ -566,12 +600,34 @@ bool keyboard_read_event(struct keyboard_event *event)
     }
 
     while (!keyboard_poll_event(event)) {
-        continue;
+        keyboard_wait();
     }
 
     return true;
 }
 
+/**
+ * Idle until a key event is queued or any other interrupt arrives.
+ *
+ * Returns at once if an event is already queued, or if interrupts are disabled
+ * and the caller has to keep polling. Any interrupt wakes it, including the
+ * Ctrl-C keystroke, but with the tick stopped a deadline only wakes it if the
+ * caller armed a timer for it.
+ */
+void keyboard_wait(void)
+{
+    if (!cpu_interrupts_enabled()) {
+        return;
+    }
+
+    cpu_irq_disable();
+    if (event_count) {
+        cpu_irq_enable();
+        return;
+    }
+    cpu_idle();
+}
+
 /**
  * Retrieve the currently active keyboard modifier flags.
  *
@@ -584,11 +640,10 @@ uint8_t keyboard_modifiers(void)
 }
 
 /**
- * Process a single PS/2 scancode received from an interrupt handler.
+ * Process a single PS/2 scancode received through IRQ1.
  *
- * This function is designed to be called from the IRQ1 (keyboard) interrupt handler
- * and processes a single scancode, updating modifier state and enqueueing events
- * without polling the keyboard port.
+ * Called from the keyboard softirq for every scancode the IRQ1 handler queued;
+ * updates modifier state and enqueues events without polling the keyboard port.
  *
  * @param scancode The PS/2 scancode to process (high bit set indicates key release).
  * @param out_char Optional pointer to receive the translated character (may be NULL).
@@ -614,3 +669,48 @@ bool keyboard_process_scancode_irq(uint8_t scancode, char *out_char)
 
     return keyboard_process_scancode(scancode, is_extended, out_char);
 }
+
+/**
+ * Keyboard bottom half: translate every scancode the IRQ1 handler queued.
+ *
+ * Runs with interrupts enabled, so translation and Ctrl-C subscribers no longer
+ * lengthen interrupt latency.
+ *
+ * @param context Unused.
+ */
+static void keyboard_softirq(void *context)
+{
+    (void)context;
+    uint8_t scancode;
+    while (ring_pop(&scancode_ring, &scancode)) {
+        (void)keyboard_process_scancode_irq(scancode, NULL);
+    }
+}
+
+/**
+ * IRQ1 handler: move the latched scancode into the ring and defer translation to the softirq.
+ *
+ * @param irq Unused.
+ * @param context Unused.
+ */
+static void keyboard_irq(unsigned int irq, void *context)
+{
+    (void)irq;
+    (void)context;
+    (void)ring_push(&scancode_ring, inb(KEYBOARD_DATA_PORT));
+    softirq_raise(SOFTIRQ_KEYBOARD);
+}
+
+/**
+ * Claim IRQ1 and the keyboard softirq so key presses are queued by interrupts. Call after idt_init().
+ *
+ * @returns `true` if both were registered, `false` if either was already taken.
+ */
+bool keyboard_init(void)
+{
+    ring_init(&scancode_ring, scancode_buffer, KEYBOARD_SCANCODE_CAPACITY);
+    if (!softirq_register(SOFTIRQ_KEYBOARD, keyboard_softirq, NULL)) {
+        return false;
+    }
+    return irq_register(IRQ_KEYBOARD, keyboard_irq, NULL);
+}
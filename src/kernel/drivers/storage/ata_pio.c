@@ -4,6 +4,7 @@
  * Description: Minimal ATA PIO driver supporting 28-bit LBA transfers for the primary master disk.
  */
 #include <lux/ata.h>
+#include <lux/event.h>
 #include <lux/io.h>
 
 #include <stdbool.h>
@@ -242,10 +243,12 @@ uint32_t ata_pio_total_sectors(void)
 
 /**
  * Read one or more 512-byte sectors from the primary master ATA device starting at the given LBA into a caller-provided buffer.
+ * Raises EVENT_DISK_DONE with the starting LBA once the whole request completed.
  *
  * @param lba Logical block address of the first sector to read (28-bit LBA range).
  * @param sector_count Number of sectors to read.
  * @param buffer Destination buffer; must be at least `sector_count * ATA_SECTOR_SIZE` bytes.
+ *
  * @returns `true` if all requested sectors were read successfully, `false` otherwise (device not ready, invalid arguments, or transfer failure).
  */
 bool ata_pio_read(uint32_t lba, uint16_t sector_count, void *buffer)
@@ -254,6 +257,7 @@ bool ata_pio_read(uint32_t lba, uint16_t sector_count, void *buffer)
         return false;
     }
 
+    uint32_t first_lba = lba;
     uint8_t *cursor = (uint8_t *)buffer;
     while (sector_count) {
         uint16_t chunk = (sector_count > ATA_TRANSFER_MAX) ? ATA_TRANSFER_MAX : sector_count;
@@ -265,15 +269,18 @@ bool ata_pio_read(uint32_t lba, uint16_t sector_count, void *buffer)
         cursor += (size_t)chunk * ATA_SECTOR_SIZE;
     }
 
+    event_raise(EVENT_DISK_DONE, first_lba);
     return true;
 }
 
 /**
  * Write consecutive 512-byte sectors to the primary master starting at the given LBA.
+ * Raises EVENT_DISK_DONE with the starting LBA once the whole request completed.
  *
  * @param lba Starting logical block address for the write.
  * @param sector_count Number of sectors to write.
  * @param buffer Pointer to the source data; must contain at least `sector_count * ATA_SECTOR_SIZE` bytes.
+ *
  * @returns `true` if all sectors were written successfully, `false` on invalid input, if the device is not ready, or if any transfer fails.
  */
 bool ata_pio_write(uint32_t lba, uint16_t sector_count, const void *buffer)
@@ -282,6 +289,7 @@ bool ata_pio_write(uint32_t lba, uint16_t sector_count, const void *buffer)
         return false;
     }
 
+    uint32_t first_lba = lba;
     const uint8_t *cursor = (const uint8_t *)buffer;
     while (sector_count) {
         uint16_t chunk = (sector_count > ATA_TRANSFER_MAX) ? ATA_TRANSFER_MAX : sector_count;
@@ -293,5 +301,6 @@ bool ata_pio_write(uint32_t lba, uint16_t sector_count, const void *buffer)
         cursor += (size_t)chunk * ATA_SECTOR_SIZE;
     }
 
+    event_raise(EVENT_DISK_DONE, first_lba);
     return true;
 }
\ No newline at end of file
@@ -28,6 +28,11 @@
 #define VGA_SEQ_DATA  0x3C5
 #define VGA_GC_INDEX  0x3CE
 #define VGA_GC_DATA   0x3CF
+#define VGA_AC_INDEX  0x3C0
+#define VGA_MISC_WRITE 0x3C2
+#define VGA_CRTC_INDEX 0x3D4
+#define VGA_CRTC_DATA  0x3D5
+#define VGA_INPUT_STATUS 0x3DA
 
 static volatile uint8_t *const VGA_MEMORY = (volatile uint8_t *)0xA0000u;
 
@@ -85,6 +90,60 @@ static inline void vga_program_palette(void)
     }
 }
 
+/**
+ * Program the VGA registers for 640x480x16 planar graphics (BIOS mode 12h).
+ *
+ * Used when the kernel was not started through the BIOS boot sector, which
+ * normally sets the mode with INT 10h. The attribute controller palette is
+ * programmed as identity so colors 0-15 map straight onto the DAC entries
+ * written by vga_program_palette().
+ */
+void tty_set_video_mode(void)
+{
+    static const uint8_t seq[5] = { 0x03, 0x01, 0x08, 0x00, 0x06 };
+    static const uint8_t crtc[25] = {
+        0x5F, 0x4F, 0x50, 0x82, 0x54, 0x80, 0x0B, 0x3E,
+        0x00, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0xEA, 0x0C, 0xDF, 0x28, 0x00, 0xE7, 0x04, 0xE3, 0xFF
+    };
+    static const uint8_t gc[9] = { 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x05, 0x0F, 0xFF };
+    static const uint8_t ac_mode[5] = { 0x01, 0x00, 0x0F, 0x00, 0x00 };
+
+    outb(VGA_MISC_WRITE, 0xE3);
+    for (uint8_t i = 0; i < sizeof(seq); ++i) {
+        outb(VGA_SEQ_INDEX, i);
+        outb(VGA_SEQ_DATA, seq[i]);
+    }
+
+    /* Unlock CRTC registers 0-7 before rewriting the timing. */
+    outb(VGA_CRTC_INDEX, 0x11);
+    outb(VGA_CRTC_DATA, inb(VGA_CRTC_DATA) & 0x7Fu);
+    for (uint8_t i = 0; i < sizeof(crtc); ++i) {
+        outb(VGA_CRTC_INDEX, i);
+        outb(VGA_CRTC_DATA, crtc[i]);
+    }
+
+    for (uint8_t i = 0; i < sizeof(gc); ++i) {
+        outb(VGA_GC_INDEX, i);
+        outb(VGA_GC_DATA, gc[i]);
+    }
+
+    /* Reading the input status register resets the AC index/data flip-flop. */
+    (void)inb(VGA_INPUT_STATUS);
+    for (uint8_t i = 0; i < 16; ++i) {
+        outb(VGA_AC_INDEX, i);
+        outb(VGA_AC_INDEX, i);
+    }
+    for (uint8_t i = 0; i < sizeof(ac_mode); ++i) {
+        outb(VGA_AC_INDEX, (uint8_t)(0x10u + i));
+        outb(VGA_AC_INDEX, ac_mode[i]);
+    }
+
+    /* Re-enable video output from the attribute controller. */
+    (void)inb(VGA_INPUT_STATUS);
+    outb(VGA_AC_INDEX, 0x20);
+}
+
 /**
  * Clear the VGA framebuffer and select all write bitplanes.
  *
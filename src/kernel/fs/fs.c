@@ -285,6 +285,21 @@ static bool disk_write_block(uint32_t block, const void *buffer)
     return ata_pio_write(LUXFS_START_LBA + block, 1, buffer);
 }
 
+/**
+ * Read consecutive filesystem data blocks into the provided buffer with a single transfer.
+ * @param index First data block index within the filesystem data region.
+ * @param count Number of blocks to read.
+ * @param buffer Pointer to a buffer of at least `count` * LUXFS_BLOCK_SIZE bytes that will receive the data.
+ * @returns `true` if the blocks were successfully read from disk, `false` otherwise.
+ */
+static bool disk_read_data_blocks(uint32_t index, uint32_t count, void *buffer)
+{
+    if (!count || index >= LUXFS_DATA_BLOCK_COUNT || count > LUXFS_DATA_BLOCK_COUNT - index) {
+        return false;
+    }
+    return ata_pio_read(LUXFS_START_LBA + LUXFS_DATA_BLOCK_START + index, (uint16_t)count, buffer);
+}
+
 /**
  * Read a filesystem data block into the provided buffer.
  * @param index Data block index within the filesystem data region (0 .. LUXFS_DATA_BLOCK_COUNT - 1).
@@ -293,10 +308,7 @@ static bool disk_write_block(uint32_t block, const void *buffer)
  */
 static bool disk_read_data_block(uint32_t index, void *buffer)
 {
-    if (index >= LUXFS_DATA_BLOCK_COUNT) {
-        return false;
-    }
-    return ata_pio_read(LUXFS_START_LBA + LUXFS_DATA_BLOCK_START + index, 1, buffer);
+    return disk_read_data_blocks(index, 1, buffer);
 }
 
 /**
@@ -1286,16 +1298,31 @@ bool fs_read(const char *path, size_t offset, void *buffer, size_t length, size_
         if (data_block == LUXFS_INVALID_BLOCK) {
             break;
         }
-        if (!disk_read_data_block(data_block, block_buffer)) {
-            return false;
-        }
 
-        size_t chunk = ATA_SECTOR_SIZE - block_offset;
-        if (chunk > remaining) {
-            chunk = remaining;
-        }
+        size_t chunk;
+        if (!block_offset && remaining >= ATA_SECTOR_SIZE) {
+            /* Whole sectors go straight into the caller's buffer, one transfer per run of adjacent blocks. */
+            uint32_t run = 1;
+            while (run < remaining / ATA_SECTOR_SIZE && block_idx + run < LUXFS_DIRECT_BLOCKS &&
+                   inode->direct[block_idx + run] == data_block + run) {
+                ++run;
+            }
+            if (!disk_read_data_blocks(data_block, run, (uint8_t *)buffer + total)) {
+                return false;
+            }
+            chunk = (size_t)run * ATA_SECTOR_SIZE;
+        } else {
+            if (!disk_read_data_block(data_block, block_buffer)) {
+                return false;
+            }
 
-        memcpy((uint8_t *)buffer + total, block_buffer + block_offset, chunk);
+            chunk = ATA_SECTOR_SIZE - block_offset;
+            if (chunk > remaining) {
+                chunk = remaining;
+            }
+
+            memcpy((uint8_t *)buffer + total, block_buffer + block_offset, chunk);
+        }
 
         total += chunk;
         remaining -= chunk;
@@ -1387,26 +1414,32 @@ bool fs_write(const char *path, size_t offset, const void *buffer, size_t length
                 return false;
             }
             inode->direct[block_idx] = new_block_index;
-            memset(block_buffer, 0, sizeof(block_buffer));
             new_block = true;
         }
 
-        if (!new_block) {
-            if (!disk_read_data_block(inode->direct[block_idx], block_buffer)) {
-                return false;
-            }
-        }
-
         size_t chunk = ATA_SECTOR_SIZE - block_offset;
         size_t remaining = length - total_written;
         if (chunk > remaining) {
             chunk = remaining;
         }
 
-        memcpy(block_buffer + block_offset, src + total_written, chunk);
+        if (chunk == ATA_SECTOR_SIZE) {
+            /* A whole sector replaces the block, so it is written from the caller's buffer without a read. */
+            if (!disk_write_data_block(inode->direct[block_idx], src + total_written)) {
+                return false;
+            }
+        } else {
+            if (new_block) {
+                memset(block_buffer, 0, sizeof(block_buffer));
+            } else if (!disk_read_data_block(inode->direct[block_idx], block_buffer)) {
+                return false;
+            }
 
-        if (!disk_write_data_block(inode->direct[block_idx], block_buffer)) {
-            return false;
+            memcpy(block_buffer + block_offset, src + total_written, chunk);
+
+            if (!disk_write_data_block(inode->direct[block_idx], block_buffer)) {
+                return false;
+            }
         }
 
         total_written += chunk;
@@ -12,10 +12,10 @@
 /**
  * Ensure the swap_file has at least `min_capacity` bytes allocated.
  *
- * If the current capacity is smaller, this function allocates a new buffer
- * (growing from 512 bytes and doubling until >= `min_capacity`), copies any
- * existing contents, frees the old buffer, and updates `swap->data` and
- * `swap->capacity`.
+ * If the current capacity is smaller, the buffer is resized with realloc()
+ * (growing from 512 bytes and doubling until >= `min_capacity`), which extends
+ * it in place when the heap allows and only copies the contents otherwise.
+ * `swap->data` and `swap->capacity` are updated on success.
  *
  * @param swap Pointer to the swap_file to grow.
  * @param min_capacity Minimum required capacity in bytes.
@@ -36,19 +36,11 @@ static bool swap_file_grow(struct swap_file *swap, size_t min_capacity)
         new_capacity *= 2u;
     }
 
-    uint8_t *new_data = malloc(new_capacity);
+    uint8_t *new_data = realloc(swap->data, new_capacity);
     if (!new_data) {
         return false;
     }
 
-    if (swap->data && swap->size) {
-        memcpy(new_data, swap->data, swap->size);
-    }
-
-    if (swap->data) {
-        free(swap->data);
-    }
-
     swap->data = new_data;
     swap->capacity = new_capacity;
     return true;
@@ -0,0 +1,196 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Bump-pointer arenas backed by page allocator blocks.
+ */
+#include <lux/arena.h>
+#include <lux/memory.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#define ARENA_ALIGNMENT   8u
+#define ARENA_CHUNK_ORDER 2u /* 16 KiB chunks unless a single request needs more */
+#define ARENA_FROM_HEAP   (PAGE_MAX_ORDER + 1u)
+
+/* Sits at the start of every chunk; the bump region follows it. */
+struct arena_chunk {
+    struct arena_chunk *next;
+    size_t order;    /* page order, or ARENA_FROM_HEAP when the chunk came from malloc() */
+    size_t capacity; /* usable bytes after the header */
+    size_t used;
+};
+
+#define ARENA_HEADER_SIZE ((sizeof(struct arena_chunk) + ARENA_ALIGNMENT - 1u) & ~(size_t)(ARENA_ALIGNMENT - 1u))
+
+static inline size_t arena_align(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1u) & ~(size_t)(ARENA_ALIGNMENT - 1u);
+}
+
+static inline uint8_t *chunk_data(struct arena_chunk *chunk)
+{
+    return (uint8_t *)chunk + ARENA_HEADER_SIZE;
+}
+
+/**
+ * Obtain a chunk with room for at least `size` bytes.
+ *
+ * Chunks come from the page allocator; when it has nothing to give (for
+ * example without a loader memory map) the heap is used instead.
+ *
+ * @param size Aligned number of bytes the chunk must hold.
+ * @returns The new chunk, or NULL if no memory is available.
+ */
+static struct arena_chunk *arena_chunk_create(size_t size)
+{
+    if (size > (size_t)-1 - ARENA_HEADER_SIZE) {
+        return 0;
+    }
+
+    size_t bytes = ARENA_HEADER_SIZE + size;
+    size_t order = page_order_for_size(bytes);
+    if (order < ARENA_CHUNK_ORDER) {
+        order = ARENA_CHUNK_ORDER;
+    }
+
+    struct arena_chunk *chunk = 0;
+    if (order <= PAGE_MAX_ORDER) {
+        chunk = (struct arena_chunk *)page_alloc(order);
+    }
+
+    if (chunk) {
+        bytes = (size_t)PAGE_SIZE << order;
+    } else {
+        if (bytes < ((size_t)PAGE_SIZE << ARENA_CHUNK_ORDER)) {
+            bytes = (size_t)PAGE_SIZE << ARENA_CHUNK_ORDER;
+        }
+        chunk = (struct arena_chunk *)malloc(bytes);
+        if (!chunk) {
+            return 0;
+        }
+        order = ARENA_FROM_HEAP;
+    }
+
+    chunk->next = 0;
+    chunk->order = order;
+    chunk->capacity = bytes - ARENA_HEADER_SIZE;
+    chunk->used = 0;
+    return chunk;
+}
+
+/**
+ * Prepare an empty arena. No memory is reserved until the first allocation.
+ *
+ * @param arena Arena to initialize; must not be NULL.
+ */
+void arena_init(struct arena *arena)
+{
+    arena->chunks = 0;
+    arena->last = 0;
+}
+
+/**
+ * Allocate `size` bytes from an arena.
+ *
+ * The memory stays valid until arena_release() and is not freed individually.
+ *
+ * @param arena Arena to allocate from.
+ * @param size Number of bytes requested.
+ * @returns 8-byte aligned pointer, or NULL if `arena` is NULL, `size` is zero or no memory is available.
+ */
+void *arena_alloc(struct arena *arena, size_t size)
+{
+    if (!arena || !size || size > (size_t)-1 - ARENA_ALIGNMENT) {
+        return 0;
+    }
+
+    size = arena_align(size);
+    struct arena_chunk *chunk = arena->chunks;
+    if (!chunk || chunk->capacity - chunk->used < size) {
+        chunk = arena_chunk_create(size);
+        if (!chunk) {
+            return 0;
+        }
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+    }
+
+    void *ptr = chunk_data(chunk) + chunk->used;
+    chunk->used += size;
+    arena->last = ptr;
+    return ptr;
+}
+
+/**
+ * Resize an arena allocation.
+ *
+ * The most recent allocation grows or shrinks in place while its chunk has
+ * room, which makes growing arrays as cheap as a pointer bump. Any other
+ * allocation keeps its address when shrinking and is copied when growing.
+ *
+ * @param arena Arena that owns `ptr`.
+ * @param ptr Allocation to resize, or NULL to behave like arena_alloc().
+ * @param old_size Size `ptr` was allocated or last resized with.
+ * @param new_size Requested size in bytes.
+ * @returns The resized allocation (possibly `ptr`), or NULL on failure, in which case `ptr` is left untouched.
+ */
+void *arena_resize(struct arena *arena, void *ptr, size_t old_size, size_t new_size)
+{
+    if (!ptr) {
+        return arena_alloc(arena, new_size);
+    }
+
+    if (!arena) {
+        return 0;
+    }
+
+    struct arena_chunk *chunk = arena->chunks;
+    if (ptr == arena->last && chunk && new_size <= (size_t)-1 - ARENA_ALIGNMENT) {
+        size_t offset = (size_t)((uint8_t *)ptr - chunk_data(chunk));
+        size_t aligned = arena_align(new_size);
+        if (aligned <= chunk->capacity - offset) {
+            chunk->used = offset + aligned;
+            return ptr;
+        }
+    }
+
+    if (new_size <= old_size) {
+        return ptr;
+    }
+
+    void *moved = arena_alloc(arena, new_size);
+    if (!moved) {
+        return 0;
+    }
+
+    memcpy(moved, ptr, old_size);
+    return moved;
+}
+
+/**
+ * Return every chunk of an arena to its allocator and leave the arena empty.
+ *
+ * All pointers obtained from the arena become invalid.
+ *
+ * @param arena Arena to release; may be NULL.
+ */
+void arena_release(struct arena *arena)
+{
+    if (!arena) {
+        return;
+    }
+
+    struct arena_chunk *chunk = arena->chunks;
+    while (chunk) {
+        struct arena_chunk *next = chunk->next;
+        if (chunk->order == ARENA_FROM_HEAP) {
+            free(chunk);
+        } else {
+            page_free(chunk, chunk->order);
+        }
+        chunk = next;
+    }
+
+    arena_init(arena);
+}
@@ -1,7 +1,7 @@
 /*
  * Date: 2025-12-10 00:00 UTC
  * Author: Lukas Fend <lukas.fend@outlook.com>
- * Description: Software implementation of 64-bit unsigned division helpers for 32-bit targets.
+ * Description: Software implementation of 64-bit division helpers for 32-bit targets.
  */
 #include <stdint.h>
 
@@ -41,4 +41,46 @@ unsigned long long __udivmoddi4(unsigned long long numerator,
     }
 
     return quotient;
-}
\ No newline at end of file
+}
+
+/**
+ * Compute the unsigned 64-bit quotient of numerator divided by denominator.
+ *
+ * Emitted by the compiler for plain 64-bit `/` on 32-bit targets.
+ *
+ * @returns The quotient, or 0 when denominator is 0.
+ */
+unsigned long long __udivdi3(unsigned long long numerator, unsigned long long denominator)
+{
+    return __udivmoddi4(numerator, denominator, 0);
+}
+
+/**
+ * Compute the unsigned 64-bit remainder of numerator divided by denominator.
+ *
+ * Emitted by the compiler for plain 64-bit `%` on 32-bit targets.
+ *
+ * @returns The remainder, or 0 when denominator is 0.
+ */
+unsigned long long __umoddi3(unsigned long long numerator, unsigned long long denominator)
+{
+    unsigned long long remainder = 0;
+    (void)__udivmoddi4(numerator, denominator, &remainder);
+    return remainder;
+}
+
+/**
+ * Compute the signed 64-bit quotient of numerator divided by denominator, truncating toward zero.
+ *
+ * Emitted by the compiler for plain 64-bit signed `/` on 32-bit targets (and at times for unsigned
+ * divisions whose operands it knows to be non-negative).
+ *
+ * @returns The quotient, or 0 when denominator is 0.
+ */
+long long __divdi3(long long numerator, long long denominator)
+{
+    unsigned long long n = numerator < 0 ? 0ULL - (unsigned long long)numerator : (unsigned long long)numerator;
+    unsigned long long d = denominator < 0 ? 0ULL - (unsigned long long)denominator : (unsigned long long)denominator;
+    unsigned long long quotient = __udivmoddi4(n, d, 0);
+    return (numerator < 0) != (denominator < 0) ? (long long)(0ULL - quotient) : (long long)quotient;
+}
@@ -1,30 +1,81 @@
 /*
  * Date: 2025-12-10 00:00 UTC
  * Author: Lukas Fend <lukas.fend@outlook.com>
- * Description: Simple first-fit allocator serving malloc/free for the kernel.
+ * Description: Segregated-fit allocator with boundary tags serving malloc/free for the kernel.
+ *              Small requests go to the slab allocator; the rest starts on a static
+ *              arena and grows into a demand-paged virtual window, or by taking
+ *              blocks from the page allocator when there is none.
  */
 #include <lux/memory.h>
+#ifdef LUX_HEAP_PROFILE
+#include <lux/time.h>
+#endif
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
 #define KERNEL_HEAP_SIZE (64 * 1024)
 #define ALIGNMENT 8u
+#define HEAP_GROW_MIN_ORDER 4u /* grow by at least 64 KiB */
+#define HEAP_MAX_ARENAS 64u
+#define HEAP_WINDOW_STEP (64u * 1024u) /* window commit granularity */
 
-struct block_header {
-    size_t size; /* bytes in payload portion */
-    struct block_header *next;
-    struct block_header *prev;
-    bool free;
+/*
+ * Every block starts with a header tag and ends with an identical footer tag
+ * holding the block size (tags included) and the in-use bit, so both
+ * neighbours of a block are reachable in O(1). Free blocks keep their bin
+ * links in the payload. Each arena is framed by an in-use prologue footer and
+ * a zero-sized in-use epilogue header, so coalescing never leaves the arena.
+ */
+#define TAG_SIZE  sizeof(size_t)
+#define TAG_USED  ((size_t)1u)
+#define TAG_MASK  (~(size_t)(ALIGNMENT - 1u))
+
+/* Bin i holds free blocks of size [2^i, 2^(i+1)). */
+#define BIN_COUNT (sizeof(size_t) * 8u)
+/* Entries inspected in the request's own bin before moving to a larger one. */
+#define BIN_SEARCH_LIMIT 4u
+
+struct free_block {
+    struct free_block *next;
+    struct free_block *prev;
 };
 
-typedef struct block_header block_header_t;
+#define MIN_BLOCK_SIZE ((2u * TAG_SIZE + sizeof(struct free_block) + ALIGNMENT - 1u) & TAG_MASK)
 
-#define MIN_SPLIT (sizeof(block_header_t) + ALIGNMENT)
+struct heap_arena {
+    uintptr_t start;
+    uintptr_t end;
+};
 
 static uint8_t kernel_heap[KERNEL_HEAP_SIZE] __attribute__((aligned(ALIGNMENT)));
-static block_header_t *heap_head;
 static bool heap_ready;
+static struct heap_arena arenas[HEAP_MAX_ARENAS];
+static size_t arena_count;
+static struct free_block *bins[BIN_COUNT];
+static size_t bin_map; /* bit i set when bins[i] is non-empty */
+
+/*
+ * The demand-paged window is a single arena whose end moves up as the heap
+ * grows. Its pages start out zero, and window_clean tracks how far blocks have
+ * ever been handed out: above it only the last block's footer and the
+ * epilogue are non-zero, so calloc() only clears what lies below.
+ * Pages below window_committed (and the page tables that map them) have their
+ * frames reserved with page_reserve(); window_tables_end is where the range
+ * whose page tables are already accounted for stops.
+ */
+static uintptr_t window_base;
+static uintptr_t window_limit;
+static struct heap_arena *window_arena; /* NULL until the window is first committed */
+static uintptr_t window_clean;
+static uintptr_t window_committed;
+static uintptr_t window_tables_end;
+
+static size_t stat_total;
+static size_t stat_used;
+static size_t stat_free;
+static size_t stat_allocations;
+static size_t stat_free_blocks;
 
 static size_t align_up(size_t size)
 {
@@ -32,89 +83,538 @@ static size_t align_up(size_t size)
     return (size + mask) & ~mask;
 }
 
+static inline size_t tag_size(size_t tag)
+{
+    return tag & TAG_MASK;
+}
+
+static inline size_t *block_header(uint8_t *block)
+{
+    return (size_t *)block;
+}
+
+static inline size_t *block_footer(uint8_t *block)
+{
+    return (size_t *)(block + tag_size(*block_header(block)) - TAG_SIZE);
+}
+
+static inline void block_set_tags(uint8_t *block, size_t size, bool used)
+{
+    size_t tag = size | (used ? TAG_USED : 0u);
+    *block_header(block) = tag;
+    *(size_t *)(block + size - TAG_SIZE) = tag;
+}
+
+static inline size_t block_payload_size(size_t size)
+{
+    return size - 2u * TAG_SIZE;
+}
+
 static bool pointer_in_heap(const void *ptr)
 {
-    uintptr_t start = (uintptr_t)kernel_heap;
-    uintptr_t end = start + KERNEL_HEAP_SIZE;
     uintptr_t addr = (uintptr_t)ptr;
-    return addr > start && addr < end;
+    for (size_t i = 0; i < arena_count; ++i) {
+        if (addr > arenas[i].start && addr < arenas[i].end) {
+            return true;
+        }
+    }
+    return false;
 }
 
-static void split_block(block_header_t *block, size_t payload_size)
+/**
+ * Map a block size to its bin (floor of log2).
+ */
+static inline size_t bin_index(size_t size)
 {
-    if (payload_size >= block->size) {
-        return;
+    return (sizeof(size_t) * 8u - 1u) - (size_t)__builtin_clzl((unsigned long)size);
+}
+
+static void bin_insert(uint8_t *block)
+{
+    size_t size = tag_size(*block_header(block));
+    size_t index = bin_index(size);
+    struct free_block *node = (struct free_block *)(block + TAG_SIZE);
+
+    node->prev = 0;
+    node->next = bins[index];
+    if (node->next) {
+        node->next->prev = node;
+    }
+    bins[index] = node;
+    bin_map |= (size_t)1u << index;
+
+    stat_free += block_payload_size(size);
+    ++stat_free_blocks;
+}
+
+static void bin_remove(uint8_t *block)
+{
+    size_t size = tag_size(*block_header(block));
+    size_t index = bin_index(size);
+    struct free_block *node = (struct free_block *)(block + TAG_SIZE);
+
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        bins[index] = node->next;
+        if (!bins[index]) {
+            bin_map &= ~((size_t)1u << index);
+        }
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+
+    stat_free -= block_payload_size(size);
+    --stat_free_blocks;
+}
+
+/**
+ * Find a free block of at least `size` bytes in bounded time.
+ *
+ * Looks at a few entries of the request's own bin, then takes the head of the
+ * next non-empty larger bin, where every block is guaranteed to fit.
+ *
+ * @returns The block (still in its bin), or NULL if no bin can satisfy the request.
+ */
+static uint8_t *find_block(size_t size)
+{
+    size_t index = bin_index(size);
+    struct free_block *node = bins[index];
+    for (size_t i = 0; node && i < BIN_SEARCH_LIMIT; ++i, node = node->next) {
+        uint8_t *block = (uint8_t *)node - TAG_SIZE;
+        if (tag_size(*block_header(block)) >= size) {
+            return block;
+        }
+    }
+
+    if (index + 1u >= BIN_COUNT) {
+        return 0;
     }
 
-    size_t remaining = block->size - payload_size;
-    if (remaining <= MIN_SPLIT) {
+    size_t larger = bin_map & ~(((size_t)1u << (index + 1u)) - 1u);
+    if (!larger) {
+        return 0;
+    }
+
+    size_t bin = (size_t)__builtin_ctzl((unsigned long)larger);
+    return (uint8_t *)bins[bin] - TAG_SIZE;
+}
+
+/**
+ * Register a memory range as a heap arena and bin its single free block.
+ *
+ * @param base Start of the arena; must be ALIGNMENT-aligned.
+ * @param size Arena size in bytes; must be a multiple of ALIGNMENT.
+ * @returns `true` on success, `false` if the arena table is full.
+ */
+static bool heap_add_arena(void *base, size_t size)
+{
+    if (arena_count >= HEAP_MAX_ARENAS) {
+        return false;
+    }
+
+    arenas[arena_count].start = (uintptr_t)base;
+    arenas[arena_count].end = (uintptr_t)base + size;
+    ++arena_count;
+
+    uint8_t *start = (uint8_t *)base;
+    size_t block_size = (size - 2u * TAG_SIZE) & TAG_MASK;
+    uint8_t *block = start + TAG_SIZE;
+
+    *(size_t *)start = TAG_USED;                /* prologue footer */
+    *(size_t *)(block + block_size) = TAG_USED; /* epilogue header */
+    block_set_tags(block, block_size, false);
+    bin_insert(block);
+
+    stat_total += block_payload_size(block_size);
+    return true;
+}
+
+/**
+ * Carve `size` bytes off the front of a free block that has already left its bin.
+ *
+ * The remainder is re-binned when it is large enough to form a block of its own.
+ */
+static void split_block(uint8_t *block, size_t size)
+{
+    size_t total = tag_size(*block_header(block));
+    size_t remaining = total - size;
+    if (remaining < MIN_BLOCK_SIZE) {
+        block_set_tags(block, total, true);
         return;
     }
 
-    uint8_t *payload = (uint8_t *)(block + 1);
-    block_header_t *new_block = (block_header_t *)(payload + payload_size);
+    block_set_tags(block, size, true);
+    uint8_t *rest = block + size;
+    block_set_tags(rest, remaining, false);
+    bin_insert(rest);
+}
+
+/**
+ * Merge a block that is being freed with free neighbours using the boundary tags.
+ *
+ * @returns The start of the merged block (not yet binned).
+ */
+static uint8_t *coalesce(uint8_t *block)
+{
+    size_t size = tag_size(*block_header(block));
 
-    new_block->size = remaining - sizeof(block_header_t);
-    new_block->free = true;
-    new_block->prev = block;
-    new_block->next = block->next;
-    if (new_block->next) {
-        new_block->next->prev = new_block;
+    uint8_t *next = block + size;
+    if (!(*block_header(next) & TAG_USED)) {
+        bin_remove(next);
+        size += tag_size(*block_header(next));
     }
 
-    block->size = payload_size;
-    block->next = new_block;
+    size_t prev_tag = *(size_t *)(block - TAG_SIZE);
+    if (!(prev_tag & TAG_USED)) {
+        uint8_t *prev = block - tag_size(prev_tag);
+        bin_remove(prev);
+        size += tag_size(prev_tag);
+        block = prev;
+    }
+
+    block_set_tags(block, size, false);
+    return block;
+}
+
+static inline bool window_contains(const uint8_t *block)
+{
+    return window_arena && (uintptr_t)block > window_arena->start && (uintptr_t)block < window_arena->end;
 }
 
-static void coalesce(block_header_t *block)
+/**
+ * Raise the clean mark of the window past an in-use block and the metadata of a free block that may follow it.
+ */
+static inline void window_note_used(uint8_t *block)
 {
-    if (block->next && block->next->free) {
-        block_header_t *next = block->next;
-        block->size += sizeof(block_header_t) + next->size;
-        block->next = next->next;
-        if (block->next) {
-            block->next->prev = block;
+    if (window_contains(block)) {
+        uintptr_t end = (uintptr_t)block + tag_size(*block_header(block)) + TAG_SIZE + sizeof(struct free_block);
+        if (end > window_clean) {
+            window_clean = end;
         }
     }
+}
+
+/**
+ * Count the bytes of a fresh payload that may be non-zero.
+ *
+ * @returns `size` outside the window, otherwise only the part below the clean mark.
+ */
+static inline size_t window_dirty_bytes(const uint8_t *payload, size_t size)
+{
+    if (!window_contains(payload) || window_clean >= (uintptr_t)payload + size) {
+        return size;
+    }
+    return window_clean > (uintptr_t)payload ? (size_t)(window_clean - (uintptr_t)payload) : 0u;
+}
 
-    if (block->prev && block->prev->free) {
-        block_header_t *prev = block->prev;
-        prev->size += sizeof(block_header_t) + block->size;
-        prev->next = block->next;
-        if (block->next) {
-            block->next->prev = prev;
+/**
+ * Commit more of the demand-paged window, enough for a `block_size` block.
+ *
+ * The first commit frames the window as an arena; later ones turn the old
+ * epilogue into the header of a new free block and merge it with a free last
+ * block. Nothing is mapped here: the page-fault handler supplies zeroed frames
+ * as the tags and payloads are first touched, drawing them from the frames
+ * reserved here for every committed page and every new page table. Growth
+ * stops once the page allocator cannot reserve them.
+ *
+ * @returns `true` if the window grew, `false` if it is full or memory is short.
+ */
+static bool heap_window_grow(size_t block_size)
+{
+    uintptr_t top = window_arena ? window_arena->end : window_base;
+    size_t needed = block_size + 2u * TAG_SIZE;
+    size_t grow = (needed + HEAP_WINDOW_STEP - 1u) & ~(size_t)(HEAP_WINDOW_STEP - 1u);
+    if (grow < needed || grow > window_limit - top) {
+        return false;
+    }
+
+    uintptr_t tables_end = (top + grow + HEAP_WINDOW_TABLE_SPAN - 1u) & ~(uintptr_t)(HEAP_WINDOW_TABLE_SPAN - 1u);
+    size_t frames = grow / PAGE_SIZE + (tables_end - window_tables_end) / HEAP_WINDOW_TABLE_SPAN;
+    if (!page_reserve(frames)) {
+        return false;
+    }
+    /* Before any tag is written, so the page-fault handler accepts the new pages. */
+    window_committed = top + grow;
+
+    if (!window_arena) {
+        if (!heap_add_arena((void *)top, grow)) {
+            page_unreserve(frames);
+            window_committed = top;
+            return false;
         }
-        block = prev;
+        window_tables_end = tables_end;
+        window_arena = &arenas[arena_count - 1u];
+        window_clean = top + 2u * TAG_SIZE + sizeof(struct free_block);
+        return true;
+    }
+
+    uint8_t *block = (uint8_t *)top - TAG_SIZE;
+    block_set_tags(block, grow, false);
+    *(size_t *)(block + grow) = TAG_USED; /* new epilogue header */
+    window_arena->end += grow;
+    window_tables_end = tables_end;
+    stat_total += grow;
+
+    uint8_t *merged = coalesce(block);
+    if (merged != block) {
+        /* The previous footer and the old epilogue are payload now; keep them zero. */
+        *(size_t *)(block - TAG_SIZE) = 0;
+        *block_header(block) = 0;
+    }
+    bin_insert(merged);
+
+    uintptr_t meta = (uintptr_t)merged + TAG_SIZE + sizeof(struct free_block);
+    if (meta > window_clean) {
+        window_clean = meta;
+    }
+    return true;
+}
+
+/**
+ * Grow the heap by enough for a `block_size` block.
+ *
+ * Without a demand-paged window (or once it is full), a new arena comes from
+ * the page allocator; arena sizes double every eight arenas so the fixed arena
+ * table can still cover most of RAM.
+ *
+ * @returns `true` if the heap grew, `false` if no memory is available.
+ */
+static bool heap_grow(size_t block_size)
+{
+    if (window_base && heap_window_grow(block_size)) {
+        return true;
+    }
+
+    size_t min_order = HEAP_GROW_MIN_ORDER + arena_count / 8u;
+    if (min_order > PAGE_MAX_ORDER) {
+        min_order = PAGE_MAX_ORDER;
+    }
+
+    size_t order = page_order_for_size(block_size + 2u * TAG_SIZE);
+    if (order < min_order) {
+        order = min_order;
+    }
+
+    void *pages = page_alloc(order);
+    if (!pages) {
+        return false;
+    }
+
+    if (!heap_add_arena(pages, (size_t)PAGE_SIZE << order)) {
+        page_free(pages, order);
+        return false;
+    }
+    return true;
+}
+
+#ifdef LUX_HEAP_PROFILE
+/*
+ * Profiling build (make HEAP_PROFILE=1): every public entry point is timed
+ * with RDTSC and attributed to its caller. Latencies go into a log-linear
+ * histogram with four sub-buckets per power of two, so percentiles are
+ * accurate to within 25%.
+ */
+#define PROFILE_SITE_SLOTS      64u /* open-addressed call-site table, power of two */
+#define PROFILE_LATENCY_OCTAVES 32u
+#define PROFILE_LATENCY_BUCKETS (PROFILE_LATENCY_OCTAVES * 4u)
+
+struct profile_latency {
+    size_t calls;
+    size_t buckets[PROFILE_LATENCY_BUCKETS];
+};
+
+static struct heap_profile_site profile_sites[PROFILE_SITE_SLOTS];
+static size_t profile_untracked;
+static size_t profile_size_classes[HEAP_PROFILE_SIZE_CLASSES];
+static struct profile_latency profile_malloc_latency;
+static struct profile_latency profile_free_latency;
+
+static size_t profile_latency_bucket(uint64_t cycles)
+{
+    if (cycles < 4u) {
+        return (size_t)cycles;
+    }
+
+    size_t msb = 63u - (size_t)__builtin_clzll(cycles);
+    if (msb >= PROFILE_LATENCY_OCTAVES) {
+        return PROFILE_LATENCY_BUCKETS - 1u;
     }
+    return msb * 4u + (size_t)((cycles >> (msb - 2u)) & 3u);
 }
 
-static block_header_t *find_block(size_t size)
+/**
+ * Report the largest cycle count that falls into a latency bucket.
+ */
+static uint64_t profile_bucket_limit(size_t bucket)
 {
-    block_header_t *current = heap_head;
-    while (current) {
-        if (current->free && current->size >= size) {
-            return current;
+    if (bucket < 4u) {
+        return bucket;
+    }
+
+    size_t msb = bucket / 4u;
+    uint64_t sub = bucket % 4u;
+    return ((4u + sub + 1u) << (msb - 2u)) - 1u;
+}
+
+/**
+ * Find or claim the call-site slot for a return address.
+ *
+ * @returns The slot, or NULL if the table is full.
+ */
+static struct heap_profile_site *profile_site(uintptr_t caller)
+{
+    size_t slot = (caller >> 2) & (PROFILE_SITE_SLOTS - 1u);
+    for (size_t probe = 0; probe < PROFILE_SITE_SLOTS; ++probe) {
+        struct heap_profile_site *site = &profile_sites[(slot + probe) & (PROFILE_SITE_SLOTS - 1u)];
+        if (site->caller == caller) {
+            return site;
+        }
+        if (!site->caller) {
+            site->caller = caller;
+            return site;
         }
-        current = current->next;
     }
     return 0;
 }
 
+static void profile_record(void *caller, bool allocation, size_t size, uint64_t cycles)
+{
+    struct profile_latency *latency = allocation ? &profile_malloc_latency : &profile_free_latency;
+    ++latency->calls;
+    ++latency->buckets[profile_latency_bucket(cycles)];
+
+    if (allocation && size) {
+        size_t order = bin_index(size) + ((size & (size - 1u)) ? 1u : 0u);
+        size_t size_class = order > 3u ? order - 3u : 0u;
+        if (size_class >= HEAP_PROFILE_SIZE_CLASSES) {
+            size_class = HEAP_PROFILE_SIZE_CLASSES - 1u;
+        }
+        ++profile_size_classes[size_class];
+    }
+
+    struct heap_profile_site *site = profile_site((uintptr_t)caller);
+    if (!site) {
+        ++profile_untracked;
+        return;
+    }
+
+    if (allocation) {
+        ++site->allocations;
+        site->bytes += size;
+    } else {
+        ++site->frees;
+    }
+    site->cycles += cycles;
+}
+
+/**
+ * Walk a latency histogram to the bucket holding the given percentile.
+ *
+ * @returns Upper cycle bound of that bucket, or 0 if nothing was recorded.
+ */
+static uint64_t profile_percentile(const struct profile_latency *latency, size_t percent)
+{
+    if (!latency->calls) {
+        return 0;
+    }
+
+    uint64_t target = ((uint64_t)latency->calls * percent + 99u) / 100u;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < PROFILE_LATENCY_BUCKETS; ++i) {
+        seen += latency->buckets[i];
+        if (seen >= target) {
+            return profile_bucket_limit(i);
+        }
+    }
+    return profile_bucket_limit(PROFILE_LATENCY_BUCKETS - 1u);
+}
+
+#define HEAP_PROFILE_BEGIN() uint64_t profile_start = clock_cycles()
+#define HEAP_PROFILE_MALLOC(size) \
+    profile_record(__builtin_return_address(0), true, (size), clock_cycles() - profile_start)
+#define HEAP_PROFILE_FREE() \
+    profile_record(__builtin_return_address(0), false, 0, clock_cycles() - profile_start)
+#else
+#define HEAP_PROFILE_BEGIN() do { } while (0)
+#define HEAP_PROFILE_MALLOC(size) do { } while (0)
+#define HEAP_PROFILE_FREE() do { } while (0)
+#endif
+
 void heap_init(void)
 {
     if (heap_ready) {
         return;
     }
 
-    heap_head = (block_header_t *)kernel_heap;
-    heap_head->size = KERNEL_HEAP_SIZE - sizeof(block_header_t);
-    heap_head->next = 0;
-    heap_head->prev = 0;
-    heap_head->free = true;
+    arena_count = 0;
+    window_base = 0;
+    window_limit = 0;
+    window_arena = 0;
+    window_clean = 0;
+    window_committed = 0;
+    window_tables_end = 0;
+    bin_map = 0;
+    memset(bins, 0, sizeof(bins));
+    stat_total = 0;
+    stat_used = 0;
+    stat_free = 0;
+    stat_allocations = 0;
+    stat_free_blocks = 0;
+    heap_add_arena(kernel_heap, KERNEL_HEAP_SIZE);
     heap_ready = true;
 }
 
-void *malloc(size_t size)
+/**
+ * Let the heap grow into a reserved virtual range whose pages are mapped on first touch.
+ *
+ * The range must read as zero wherever it has not been written, and accesses
+ * to it must be serviced (by the page-fault handler) before this is called.
+ * Growth uses the window first and falls back to page allocator arenas once
+ * it is exhausted.
+ *
+ * @param base Start of the range; must be page-aligned.
+ * @param size Length of the range in bytes.
+ * @returns `true` on success, `false` if the range is unusable or a window is already set.
+ */
+bool heap_add_window(void *base, size_t size)
+{
+    if (!heap_ready) {
+        heap_init();
+    }
+
+    uintptr_t start = (uintptr_t)base;
+    if (window_base || !start || (start & (PAGE_SIZE - 1u)) || size < HEAP_WINDOW_STEP || size > (uintptr_t)-1 - start) {
+        return false;
+    }
+
+    window_base = start;
+    window_limit = start + (size & ~(size_t)(HEAP_WINDOW_STEP - 1u));
+    window_committed = start;
+    window_tables_end = start & ~(uintptr_t)(HEAP_WINDOW_TABLE_SPAN - 1u);
+    return true;
+}
+
+/**
+ * Report whether an address lies in the committed part of the heap window.
+ *
+ * @param addr Address to check.
+ * @returns `true` if the heap has reserved a frame for the page holding `addr`.
+ */
+bool heap_window_committed(uintptr_t addr)
+{
+    return addr >= window_base && addr < window_committed;
+}
+
+/**
+ * Allocate `size` bytes, optionally zeroed.
+ *
+ * @param size Requested size in bytes.
+ * @param zero Clear the payload; untouched window memory is skipped because it is still zero.
+ * @returns The payload, or NULL on failure.
+ */
+static void *heap_malloc(size_t size, bool zero)
 {
     if (!size) {
         return 0;
@@ -124,35 +624,279 @@ void *malloc(size_t size)
         heap_init();
     }
 
-    size_t aligned = align_up(size);
-    block_header_t *block = find_block(aligned);
-    if (!block) {
+    if (size <= SLAB_MAX_SIZE) {
+        void *object = slab_alloc(size);
+        if (object) {
+            if (zero) {
+                memset(object, 0, size);
+            }
+            return object;
+        }
+    }
+
+    if (size > (size_t)-1 - 2u * TAG_SIZE - ALIGNMENT) {
         return 0;
     }
 
-    split_block(block, aligned);
-    block->free = false;
-    return (void *)(block + 1);
+    size_t block_size = align_up(size + 2u * TAG_SIZE);
+    if (block_size < MIN_BLOCK_SIZE) {
+        block_size = MIN_BLOCK_SIZE;
+    }
+
+    uint8_t *block = find_block(block_size);
+    if (!block) {
+        if (!heap_grow(block_size)) {
+            return 0;
+        }
+        block = find_block(block_size);
+        if (!block) {
+            return 0;
+        }
+    }
+
+    bin_remove(block);
+    split_block(block, block_size);
+
+    uint8_t *payload = block + TAG_SIZE;
+    if (zero) {
+        memset(payload, 0, window_dirty_bytes(payload, size));
+    }
+    window_note_used(block);
+
+    stat_used += block_payload_size(tag_size(*block_header(block)));
+    ++stat_allocations;
+    return payload;
 }
 
-void free(void *ptr)
+static void heap_free(void *ptr)
 {
-    if (!ptr || !heap_ready || !pointer_in_heap(ptr)) {
+    if (!ptr || slab_free(ptr)) {
+        return;
+    }
+
+    if (!heap_ready || !pointer_in_heap(ptr)) {
         return;
     }
 
-    block_header_t *block = ((block_header_t *)ptr) - 1;
-    if (block->free) {
+    uint8_t *block = (uint8_t *)ptr - TAG_SIZE;
+    size_t tag = *block_header(block);
+    if (!(tag & TAG_USED) || *block_footer(block) != tag) {
         return;
     }
 
-    block->free = true;
-    coalesce(block);
+    stat_used -= block_payload_size(tag_size(tag));
+    --stat_allocations;
+    bin_insert(coalesce(block));
+}
+
+static void *heap_realloc(void *ptr, size_t size)
+{
+    if (!ptr) {
+        return heap_malloc(size, false);
+    }
+
+    if (!size) {
+        heap_free(ptr);
+        return 0;
+    }
+
+    size_t old_size = slab_object_size(ptr);
+    if (old_size) {
+        if (size <= old_size) {
+            return ptr;
+        }
+    } else {
+        if (!heap_ready || !pointer_in_heap(ptr)) {
+            return 0;
+        }
+
+        uint8_t *block = (uint8_t *)ptr - TAG_SIZE;
+        size_t tag = *block_header(block);
+        if (!(tag & TAG_USED) || *block_footer(block) != tag) {
+            return 0;
+        }
+
+        size_t current = tag_size(tag);
+        old_size = block_payload_size(current);
+        if (size <= (size_t)-1 - 2u * TAG_SIZE - ALIGNMENT) {
+            size_t block_size = align_up(size + 2u * TAG_SIZE);
+            if (block_size < MIN_BLOCK_SIZE) {
+                block_size = MIN_BLOCK_SIZE;
+            }
+
+            uint8_t *next = block + current;
+            size_t available = current;
+            if (block_size > current && !(*block_header(next) & TAG_USED)) {
+                available += tag_size(*block_header(next));
+            }
+
+            if (block_size <= available) {
+                stat_used -= old_size;
+                if (available > current) {
+                    bin_remove(next);
+                    block_set_tags(block, available, true);
+                }
+                if (available - block_size >= MIN_BLOCK_SIZE) {
+                    block_set_tags(block, block_size, true);
+                    uint8_t *rest = block + block_size;
+                    block_set_tags(rest, available - block_size, false);
+                    bin_insert(coalesce(rest));
+                }
+                window_note_used(block);
+                stat_used += block_payload_size(tag_size(*block_header(block)));
+                return ptr;
+            }
+        }
+    }
+
+    void *moved = heap_malloc(size, false);
+    if (!moved) {
+        return 0;
+    }
+
+    memcpy(moved, ptr, old_size < size ? old_size : size);
+    heap_free(ptr);
+    return moved;
+}
+
+/**
+ * Allocate a heap block whose payload starts on an `alignment` boundary.
+ *
+ * Takes a free block with room for the worst-case padding, then gives the
+ * leading fragment before the aligned payload back to the bins (moving on to
+ * the next boundary while that fragment would be too small to stand alone) and
+ * splits off the tail as usual, so no padding stays attached to the block.
+ */
+static void *heap_aligned_alloc(size_t alignment, size_t size)
+{
+    if (size > (size_t)-1 - 2u * TAG_SIZE - ALIGNMENT) {
+        return 0;
+    }
+
+    size_t block_size = align_up(size + 2u * TAG_SIZE);
+    if (block_size < MIN_BLOCK_SIZE) {
+        block_size = MIN_BLOCK_SIZE;
+    }
+    if (block_size > (size_t)-1 - alignment - MIN_BLOCK_SIZE) {
+        return 0;
+    }
+
+    size_t search_size = block_size + alignment + MIN_BLOCK_SIZE;
+    uint8_t *block = find_block(search_size);
+    if (!block) {
+        if (!heap_grow(search_size)) {
+            return 0;
+        }
+        block = find_block(search_size);
+        if (!block) {
+            return 0;
+        }
+    }
+
+    bin_remove(block);
+
+    uintptr_t payload = (uintptr_t)block + TAG_SIZE;
+    uintptr_t aligned = (payload + alignment - 1u) & ~(uintptr_t)(alignment - 1u);
+    while (aligned != payload && aligned - payload < MIN_BLOCK_SIZE) {
+        aligned += alignment;
+    }
+
+    size_t lead = (size_t)(aligned - payload);
+    if (lead) {
+        /* The neighbours of a free block are in use, so the fragment needs no coalescing. */
+        size_t total = tag_size(*block_header(block));
+        block_set_tags(block, lead, false);
+        bin_insert(block);
+        block += lead;
+        block_set_tags(block, total - lead, false);
+    }
+
+    split_block(block, block_size);
+    window_note_used(block);
+
+    stat_used += block_payload_size(tag_size(*block_header(block)));
+    ++stat_allocations;
+    return block + TAG_SIZE;
+}
+
+void *malloc(size_t size)
+{
+    HEAP_PROFILE_BEGIN();
+    void *ptr = heap_malloc(size, false);
+    HEAP_PROFILE_MALLOC(size);
+    return ptr;
+}
+
+void free(void *ptr)
+{
+    HEAP_PROFILE_BEGIN();
+    heap_free(ptr);
+    HEAP_PROFILE_FREE();
+}
+
+/**
+ * Resize an allocation, preferring to do so in place.
+ *
+ * Heap blocks shrink by splitting off their tail and grow by absorbing a free
+ * successor block; only when neither applies is the data moved to a new
+ * allocation. Slab objects stay put while the new size still fits their class.
+ *
+ * @param ptr Allocation to resize, or NULL to behave like malloc().
+ * @param size New size in bytes; 0 frees `ptr` and returns NULL.
+ * @returns Pointer to the resized allocation (possibly `ptr`), or NULL on failure, in which case `ptr` is left untouched.
+ */
+void *realloc(void *ptr, size_t size)
+{
+    HEAP_PROFILE_BEGIN();
+    void *resized = heap_realloc(ptr, size);
+    HEAP_PROFILE_MALLOC(size);
+    return resized;
+}
+
+/**
+ * Allocate memory whose address is a multiple of `alignment`.
+ *
+ * Requests that fit a slab class come from the class of at least `alignment`
+ * bytes, whose objects are naturally aligned to their size. Larger requests
+ * are carved from the heap with the alignment padding returned to the free
+ * bins. The result is released with free() like any other allocation.
+ *
+ * @param alignment Required alignment; must be a power of two.
+ * @param size Number of bytes to allocate.
+ * @returns Aligned pointer, or NULL if `size` is zero, `alignment` is not a power of two, or no memory is available.
+ */
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    if (!size || !alignment || (alignment & (alignment - 1u))) {
+        return 0;
+    }
+
+    if (alignment <= ALIGNMENT) {
+        return malloc(size);
+    }
+
+    HEAP_PROFILE_BEGIN();
+    if (!heap_ready) {
+        heap_init();
+    }
+
+    void *ptr = 0;
+    size_t slab_size = size > alignment ? size : alignment;
+    if (slab_size <= SLAB_MAX_SIZE) {
+        ptr = slab_alloc(slab_size);
+    }
+    if (!ptr) {
+        ptr = heap_aligned_alloc(alignment, size);
+    }
+    HEAP_PROFILE_MALLOC(size);
+    return ptr;
 }
 
 /**
  * Allocate and zero-initialize an array of `count` elements each of `size` bytes.
  *
+ * Memory taken from never-used parts of the demand-paged window is already zero and is not cleared again.
+ *
  * @param count Number of elements to allocate.
  * @param size  Size in bytes of each element.
  * @returns Pointer to the allocated, zeroed memory on success; `NULL` if `count` or `size` is zero, if `count * size` would overflow, or if allocation fails.
@@ -168,12 +912,9 @@ void *calloc(size_t count, size_t size)
         return 0;
     }
 
-    void *ptr = malloc(total);
-    if (!ptr) {
-        return 0;
-    }
-
-    memset(ptr, 0, total);
+    HEAP_PROFILE_BEGIN();
+    void *ptr = heap_malloc(total, true);
+    HEAP_PROFILE_MALLOC(total);
     return ptr;
 }
 
@@ -181,15 +922,15 @@ void *calloc(size_t count, size_t size)
  * Populate heap usage statistics for the kernel heap.
  *
  * Fills the provided heap_stats structure with:
- * - total_bytes: total payload bytes available in the heap
+ * - total_bytes: payload bytes the heap arenas could hold as single free blocks
  * - used_bytes: sum of payload bytes in allocated blocks
  * - free_bytes: sum of payload bytes in free blocks
  * - largest_free_block: size of the largest free payload block
  * - allocation_count: number of allocated blocks
  * - free_block_count: number of free blocks
  *
- * If the heap is not initialized, the function returns baseline values that represent
- * a single free block spanning the entire heap payload.
+ * All counters except largest_free_block are maintained incrementally; the
+ * largest block is found by scanning only the highest non-empty bin.
  *
  * @param stats Pointer to a heap_stats structure to populate; must not be NULL.
  * @returns true on success, false if `stats` is NULL.
@@ -200,44 +941,84 @@ bool heap_get_stats(struct heap_stats *stats)
         return false;
     }
 
-    size_t total_payload = KERNEL_HEAP_SIZE - sizeof(block_header_t);
-
-    if (!heap_ready || !heap_head) {
-        stats->total_bytes = total_payload;
-        stats->used_bytes = 0;
-        stats->free_bytes = total_payload;
-        stats->largest_free_block = total_payload;
-        stats->allocation_count = 0;
-        stats->free_block_count = 1;
-        return true;
+    if (!heap_ready) {
+        heap_init();
     }
 
-    size_t used = 0;
-    size_t free = 0;
     size_t largest_free = 0;
-    size_t allocated_blocks = 0;
-    size_t free_blocks = 0;
-
-    block_header_t *current = heap_head;
-    while (current) {
-        if (current->free) {
-            free += current->size;
-            ++free_blocks;
-            if (current->size > largest_free) {
-                largest_free = current->size;
+    if (bin_map) {
+        size_t top = (sizeof(size_t) * 8u - 1u) - (size_t)__builtin_clzl((unsigned long)bin_map);
+        for (struct free_block *node = bins[top]; node; node = node->next) {
+            size_t size = block_payload_size(tag_size(*block_header((uint8_t *)node - TAG_SIZE)));
+            if (size > largest_free) {
+                largest_free = size;
             }
-        } else {
-            used += current->size;
-            ++allocated_blocks;
         }
-        current = current->next;
     }
 
-    stats->total_bytes = total_payload;
-    stats->used_bytes = used;
-    stats->free_bytes = free;
+    stats->total_bytes = stat_total;
+    stats->used_bytes = stat_used;
+    stats->free_bytes = stat_free;
     stats->largest_free_block = largest_free;
-    stats->allocation_count = allocated_blocks;
-    stats->free_block_count = free_blocks;
+    stats->allocation_count = stat_allocations;
+    stats->free_block_count = stat_free_blocks;
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * Collect the allocation profile recorded by a LUX_HEAP_PROFILE build.
+ *
+ * Call sites are returned busiest first (by malloc plus free calls); sites
+ * beyond HEAP_PROFILE_TOP_SITES are left out. Latency percentiles are in TSC
+ * cycles and include the profiling overhead of one RDTSC.
+ *
+ * @param profile Structure to fill; must not be NULL.
+ * @returns `true` on success, `false` if `profile` is NULL or the kernel was built without profiling.
+ */
+bool heap_get_profile(struct heap_profile *profile)
+{
+#ifdef LUX_HEAP_PROFILE
+    if (!profile) {
+        return false;
+    }
+
+    memset(profile, 0, sizeof(*profile));
+    for (size_t i = 0; i < PROFILE_SITE_SLOTS; ++i) {
+        const struct heap_profile_site *site = &profile_sites[i];
+        if (!site->caller) {
+            continue;
+        }
+
+        size_t calls = site->allocations + site->frees;
+        size_t pos = profile->site_count;
+        if (pos == HEAP_PROFILE_TOP_SITES) {
+            const struct heap_profile_site *tail = &profile->sites[pos - 1u];
+            if (calls <= tail->allocations + tail->frees) {
+                continue;
+            }
+            --pos;
+        } else {
+            ++profile->site_count;
+        }
+
+        while (pos > 0 && profile->sites[pos - 1u].allocations + profile->sites[pos - 1u].frees < calls) {
+            profile->sites[pos] = profile->sites[pos - 1u];
+            --pos;
+        }
+        profile->sites[pos] = *site;
+    }
+
+    profile->untracked_calls = profile_untracked;
+    memcpy(profile->size_classes, profile_size_classes, sizeof(profile_size_classes));
+    profile->malloc_calls = profile_malloc_latency.calls;
+    profile->free_calls = profile_free_latency.calls;
+    profile->malloc_p50 = profile_percentile(&profile_malloc_latency, 50u);
+    profile->malloc_p99 = profile_percentile(&profile_malloc_latency, 99u);
+    profile->free_p50 = profile_percentile(&profile_free_latency, 50u);
+    profile->free_p99 = profile_percentile(&profile_free_latency, 99u);
+    return true;
+#else
+    (void)profile;
+    return false;
+#endif
+}
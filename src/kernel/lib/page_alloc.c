@@ -0,0 +1,416 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Buddy page-frame allocator managing the usable RAM reported by the loader.
+ */
+#include <lux/boot.h>
+#include <lux/event.h>
+#include <lux/memory.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Low memory (BIOS data, boot handoff, VGA) plus the kernel image, .bss and boot stack. */
+#define PAGE_RESERVED_END 0x00200000u
+/* Frames must stay reachable through the identity map, which the heap window interrupts. */
+#define PAGE_ADDR_LIMIT   ((uint64_t)HEAP_WINDOW_BASE)
+
+/*
+ * One byte per physical frame. Only the first frame of a block carries state;
+ * frames inside a block stay 0, except in slab blocks where every frame
+ * carries FRAME_SLAB | order so any object address leads back to its slab.
+ */
+#define FRAME_ORDER_MASK 0x0Fu
+#define FRAME_FREE       0x10u
+#define FRAME_ALLOCATED  0x20u
+#define FRAME_SLAB       0x40u
+#define FRAME_RESERVED   0x80u
+
+struct free_page {
+    struct free_page *next;
+    struct free_page *prev;
+};
+
+static uint8_t *frame_map;
+static size_t frame_count;
+static struct free_page *free_lists[PAGE_MAX_ORDER + 1];
+static size_t free_counts[PAGE_MAX_ORDER + 1];
+static size_t managed_pages;
+static size_t free_pages;
+static size_t reserved_pages;
+static bool low_memory_signalled;
+
+static inline void *frame_address(size_t pfn)
+{
+    return (void *)(uintptr_t)(pfn * PAGE_SIZE);
+}
+
+static inline size_t frame_number(const void *addr)
+{
+    return (uintptr_t)addr / PAGE_SIZE;
+}
+
+/**
+ * Insert a block at the head of its order's free list and tag its first frame.
+ *
+ * @param pfn First frame of the block.
+ * @param order Block order.
+ */
+static void free_list_push(size_t pfn, size_t order)
+{
+    struct free_page *page = (struct free_page *)frame_address(pfn);
+    page->prev = 0;
+    page->next = free_lists[order];
+    if (page->next) {
+        page->next->prev = page;
+    }
+    free_lists[order] = page;
+    ++free_counts[order];
+    frame_map[pfn] = (uint8_t)(FRAME_FREE | order);
+}
+
+/**
+ * Unlink a free block from its order's free list and clear its tag.
+ *
+ * @param pfn First frame of the block.
+ * @param order Block order.
+ */
+static void free_list_remove(size_t pfn, size_t order)
+{
+    struct free_page *page = (struct free_page *)frame_address(pfn);
+    if (page->prev) {
+        page->prev->next = page->next;
+    } else {
+        free_lists[order] = page->next;
+    }
+    if (page->next) {
+        page->next->prev = page->prev;
+    }
+    --free_counts[order];
+    frame_map[pfn] = 0;
+}
+
+/**
+ * Hand a frame range to the allocator as the largest naturally aligned blocks that fit.
+ *
+ * @param first First frame of the range.
+ * @param end Frame one past the end of the range.
+ */
+static void page_release_range(size_t first, size_t end)
+{
+    while (first < end) {
+        size_t order = PAGE_MAX_ORDER;
+        while (order && ((first & ((1u << order) - 1u)) || first + (1u << order) > end)) {
+            --order;
+        }
+        memset(frame_map + first, 0, (size_t)1 << order);
+        free_list_push(first, order);
+        managed_pages += (size_t)1 << order;
+        free_pages += (size_t)1 << order;
+        first += (size_t)1 << order;
+    }
+}
+
+/**
+ * Clamp an available memory map region to whole frames inside the managed window.
+ *
+ * @param entry Memory map entry to clamp.
+ * @param first Receives the first usable frame.
+ * @param end Receives the frame one past the last usable frame.
+ * @returns `true` if at least one frame remains, `false` otherwise.
+ */
+static bool page_region_frames(const struct boot_mmap_entry *entry, size_t *first, size_t *end)
+{
+    if (entry->type != BOOT_MMAP_AVAILABLE) {
+        return false;
+    }
+
+    uint64_t start = entry->base;
+    uint64_t stop = entry->base + entry->length;
+    if (start < PAGE_RESERVED_END) {
+        start = PAGE_RESERVED_END;
+    }
+    if (stop > PAGE_ADDR_LIMIT) {
+        stop = PAGE_ADDR_LIMIT;
+    }
+
+    start = (start + PAGE_SIZE - 1u) & ~(uint64_t)(PAGE_SIZE - 1u);
+    stop &= ~(uint64_t)(PAGE_SIZE - 1u);
+    if (start >= stop) {
+        return false;
+    }
+
+    *first = (size_t)(start / PAGE_SIZE);
+    *end = (size_t)(stop / PAGE_SIZE);
+    return true;
+}
+
+/**
+ * Build the frame map and free lists from the loader's memory map.
+ *
+ * The frame map is carved from the start of the first available region large
+ * enough to hold it. Without a memory map the allocator stays empty and every
+ * page_alloc() call fails, leaving the heap on its static arena.
+ */
+void page_alloc_init(void)
+{
+    const struct boot_info *boot = boot_info_get();
+    size_t first;
+    size_t end;
+
+    frame_map = 0;
+    frame_count = 0;
+    managed_pages = 0;
+    free_pages = 0;
+    reserved_pages = 0;
+    low_memory_signalled = false;
+    memset(free_lists, 0, sizeof(free_lists));
+    memset(free_counts, 0, sizeof(free_counts));
+
+    for (size_t i = 0; i < boot->mmap_count; ++i) {
+        if (page_region_frames(&boot->mmap[i], &first, &end) && end > frame_count) {
+            frame_count = end;
+        }
+    }
+    if (!frame_count) {
+        return;
+    }
+
+    size_t map_pages = (frame_count + PAGE_SIZE - 1u) / PAGE_SIZE;
+    for (size_t i = 0; i < boot->mmap_count && !frame_map; ++i) {
+        if (page_region_frames(&boot->mmap[i], &first, &end) && end - first >= map_pages) {
+            frame_map = (uint8_t *)frame_address(first);
+        }
+    }
+    if (!frame_map) {
+        frame_count = 0;
+        return;
+    }
+
+    memset(frame_map, FRAME_RESERVED, frame_count);
+
+    /* The map is sorted by base; clamping to released_end drops overlapping firmware entries. */
+    size_t map_first = frame_number(frame_map);
+    size_t map_end = map_first + map_pages;
+    size_t released_end = 0;
+    for (size_t i = 0; i < boot->mmap_count; ++i) {
+        if (!page_region_frames(&boot->mmap[i], &first, &end)) {
+            continue;
+        }
+        if (first < released_end) {
+            first = released_end;
+        }
+        if (first >= end) {
+            continue;
+        }
+        released_end = end;
+        if (first < map_end && end > map_first) {
+            if (first < map_first) {
+                page_release_range(first, map_first);
+            }
+            first = map_end;
+        }
+        if (first < end) {
+            page_release_range(first, end);
+        }
+    }
+}
+
+/**
+ * Allocate a naturally aligned block of 2^order contiguous physical pages.
+ *
+ * Frames promised by page_reserve() are not handed out here.
+ *
+ * @param order Block order (0 = one page, PAGE_MAX_ORDER = largest block).
+ * @returns Address of the first page, or NULL if the order is invalid or no block is free.
+ */
+void *page_alloc(size_t order)
+{
+    if (order > PAGE_MAX_ORDER || free_pages - reserved_pages < ((size_t)1 << order)) {
+        return 0;
+    }
+
+    size_t current = order;
+    while (current <= PAGE_MAX_ORDER && !free_lists[current]) {
+        ++current;
+    }
+    if (current > PAGE_MAX_ORDER) {
+        return 0;
+    }
+
+    size_t pfn = frame_number(free_lists[current]);
+    free_list_remove(pfn, current);
+
+    while (current > order) {
+        --current;
+        free_list_push(pfn + ((size_t)1 << current), current);
+    }
+
+    frame_map[pfn] = (uint8_t)(FRAME_ALLOCATED | order);
+    free_pages -= (size_t)1 << order;
+    /* Posted (not raised) because the page-fault handler allocates with interrupts off. */
+    if (!low_memory_signalled && free_pages < managed_pages / 16u) {
+        low_memory_signalled = true;
+        event_post(EVENT_LOW_MEMORY, (uint32_t)free_pages);
+    }
+    return frame_address(pfn);
+}
+
+/**
+ * Set aside free frames for later page_alloc_reserved() calls.
+ *
+ * The heap reserves the frames (and page tables) behind window memory when it
+ * commits it, so running out of RAM fails the allocation instead of the page
+ * fault that would otherwise have to back it.
+ *
+ * @param count Number of frames to set aside.
+ * @returns `true` on success, `false` if fewer than `count` unreserved frames are free.
+ */
+bool page_reserve(size_t count)
+{
+    if (count > free_pages - reserved_pages) {
+        return false;
+    }
+    reserved_pages += count;
+    return true;
+}
+
+/**
+ * Give back frames set aside by page_reserve() that will not be used.
+ *
+ * @param count Number of frames; clamped to the outstanding reservation.
+ */
+void page_unreserve(size_t count)
+{
+    reserved_pages -= count < reserved_pages ? count : reserved_pages;
+}
+
+/**
+ * Allocate one page out of the frames set aside by page_reserve().
+ *
+ * @returns Address of the page, or NULL if nothing is reserved.
+ */
+void *page_alloc_reserved(void)
+{
+    if (!reserved_pages) {
+        return 0;
+    }
+
+    --reserved_pages;
+    void *page = page_alloc(0);
+    if (!page) {
+        ++reserved_pages;
+    }
+    return page;
+}
+
+/**
+ * Return a block obtained from page_alloc() and merge it with free buddies.
+ *
+ * Blocks that were not allocated with the given order are ignored.
+ *
+ * @param page Address returned by page_alloc().
+ * @param order Order passed to page_alloc().
+ */
+void page_free(void *page, size_t order)
+{
+    if (!page || order > PAGE_MAX_ORDER || ((uintptr_t)page & (PAGE_SIZE - 1u))) {
+        return;
+    }
+
+    size_t pfn = frame_number(page);
+    if (pfn >= frame_count || (frame_map[pfn] & (uint8_t)~FRAME_SLAB) != (uint8_t)(FRAME_ALLOCATED | order)) {
+        return;
+    }
+
+    if (frame_map[pfn] & FRAME_SLAB) {
+        memset(frame_map + pfn, 0, (size_t)1 << order);
+    }
+    frame_map[pfn] = 0;
+    free_pages += (size_t)1 << order;
+    if (low_memory_signalled && free_pages >= managed_pages / 8u) {
+        low_memory_signalled = false;
+    }
+
+    while (order < PAGE_MAX_ORDER) {
+        size_t buddy = pfn ^ ((size_t)1 << order);
+        if (buddy >= frame_count || frame_map[buddy] != (uint8_t)(FRAME_FREE | order)) {
+            break;
+        }
+        free_list_remove(buddy, order);
+        pfn &= ~((size_t)1 << order);
+        ++order;
+    }
+
+    free_list_push(pfn, order);
+}
+
+/**
+ * Tag every frame of an allocated block as belonging to a slab.
+ *
+ * @param page Address returned by page_alloc().
+ * @param order Order passed to page_alloc().
+ */
+void page_mark_slab(void *page, size_t order)
+{
+    size_t pfn = frame_number(page);
+    if (pfn >= frame_count || frame_map[pfn] != (uint8_t)(FRAME_ALLOCATED | order)) {
+        return;
+    }
+
+    memset(frame_map + pfn, (int)(FRAME_SLAB | order), (size_t)1 << order);
+    frame_map[pfn] = (uint8_t)(FRAME_ALLOCATED | FRAME_SLAB | order);
+}
+
+/**
+ * Look up the slab block containing an address.
+ *
+ * @param addr Any address inside the block.
+ * @returns Order of the slab block, or PAGE_MAX_ORDER + 1 if the address is not inside a slab.
+ */
+size_t page_slab_order(const void *addr)
+{
+    size_t pfn = frame_number(addr);
+    if (!frame_map || pfn >= frame_count || !(frame_map[pfn] & FRAME_SLAB)) {
+        return PAGE_MAX_ORDER + 1u;
+    }
+    return frame_map[pfn] & FRAME_ORDER_MASK;
+}
+
+/**
+ * Compute the smallest block order that covers a byte count.
+ *
+ * @param size Number of bytes required.
+ * @returns Block order, or PAGE_MAX_ORDER + 1 if the size exceeds the largest block.
+ */
+size_t page_order_for_size(size_t size)
+{
+    size_t order = 0;
+    while (order <= PAGE_MAX_ORDER && ((size_t)PAGE_SIZE << order) < size) {
+        ++order;
+    }
+    return order;
+}
+
+/**
+ * Populate page allocator statistics.
+ *
+ * @param stats Structure to fill; must not be NULL.
+ * @returns `true` on success, `false` if `stats` is NULL.
+ */
+bool page_get_stats(struct page_stats *stats)
+{
+    if (!stats) {
+        return false;
+    }
+
+    stats->total_pages = managed_pages;
+    stats->free_pages = free_pages;
+    stats->reserved_pages = reserved_pages;
+    for (size_t order = 0; order <= PAGE_MAX_ORDER; ++order) {
+        stats->free_blocks[order] = free_counts[order];
+    }
+    return true;
+}
@@ -0,0 +1,276 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Power-of-two size-class slab allocator serving small malloc requests.
+ */
+#include <lux/memory.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Each slab holds at least this many objects, so large classes use multi-page slabs. */
+#define SLAB_MIN_OBJECTS 16u
+
+/*
+ * Lives at the tail of its slab so objects start at the slab base and stay
+ * aligned to their (power-of-two) size.
+ */
+struct slab {
+    struct slab *next;
+    struct slab *prev;
+    void *free_objects;
+    uint16_t in_use;
+    uint16_t capacity;
+    uint8_t class_index;
+};
+
+struct slab_free_object {
+    struct slab_free_object *next;
+};
+
+struct slab_class {
+    size_t object_size;
+    size_t order;
+    struct slab *partial; /* slabs with at least one free object */
+    size_t hits;
+    size_t misses;
+    size_t objects_in_use;
+    size_t objects_total;
+    size_t slab_count;
+};
+
+static struct slab_class classes[SLAB_CLASS_COUNT];
+static bool slab_ready;
+
+/**
+ * Configure object sizes and slab orders for every class.
+ */
+static void slab_init(void)
+{
+    for (size_t i = 0; i < SLAB_CLASS_COUNT; ++i) {
+        struct slab_class *cls = &classes[i];
+        memset(cls, 0, sizeof(*cls));
+        cls->object_size = (size_t)SLAB_MIN_SIZE << i;
+        /* The tail header shares the slab, so reserve room for it on top of the objects. */
+        cls->order = page_order_for_size(cls->object_size * SLAB_MIN_OBJECTS + sizeof(struct slab));
+    }
+    slab_ready = true;
+}
+
+/**
+ * Map a request size to its size class.
+ *
+ * @param size Requested size in bytes (1 .. SLAB_MAX_SIZE).
+ * @returns Index of the smallest class whose objects fit `size`.
+ */
+static size_t slab_class_index(size_t size)
+{
+    size_t index = 0;
+    while (((size_t)SLAB_MIN_SIZE << index) < size) {
+        ++index;
+    }
+    return index;
+}
+
+static inline size_t slab_bytes(const struct slab_class *cls)
+{
+    return (size_t)PAGE_SIZE << cls->order;
+}
+
+static inline struct slab *slab_header(void *base, const struct slab_class *cls)
+{
+    return (struct slab *)((uint8_t *)base + slab_bytes(cls) - sizeof(struct slab));
+}
+
+static void slab_list_push(struct slab_class *cls, struct slab *slab)
+{
+    slab->prev = 0;
+    slab->next = cls->partial;
+    if (slab->next) {
+        slab->next->prev = slab;
+    }
+    cls->partial = slab;
+}
+
+static void slab_list_remove(struct slab_class *cls, struct slab *slab)
+{
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        cls->partial = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    slab->next = 0;
+    slab->prev = 0;
+}
+
+/**
+ * Take a fresh slab from the page allocator and thread its objects onto a free list.
+ *
+ * @param cls Class the slab will serve.
+ * @param class_index Index of `cls` in the class table.
+ * @returns The new slab (already on the partial list), or NULL if no pages are available.
+ */
+static struct slab *slab_create(struct slab_class *cls, size_t class_index)
+{
+    uint8_t *base = page_alloc(cls->order);
+    if (!base) {
+        return 0;
+    }
+    page_mark_slab(base, cls->order);
+
+    struct slab *slab = slab_header(base, cls);
+    size_t capacity = (slab_bytes(cls) - sizeof(struct slab)) / cls->object_size;
+
+    struct slab_free_object *head = 0;
+    for (size_t i = capacity; i > 0; --i) {
+        struct slab_free_object *object = (struct slab_free_object *)(base + (i - 1u) * cls->object_size);
+        object->next = head;
+        head = object;
+    }
+
+    slab->free_objects = head;
+    slab->in_use = 0;
+    slab->capacity = (uint16_t)capacity;
+    slab->class_index = (uint8_t)class_index;
+    slab_list_push(cls, slab);
+
+    cls->objects_total += capacity;
+    ++cls->slab_count;
+    return slab;
+}
+
+/**
+ * Find the slab header for an object address.
+ *
+ * @returns The owning slab, or NULL if `ptr` does not point into a slab.
+ */
+static struct slab *slab_lookup(const void *ptr)
+{
+    size_t order = page_slab_order(ptr);
+    if (order > PAGE_MAX_ORDER) {
+        return 0;
+    }
+
+    size_t bytes = (size_t)PAGE_SIZE << order;
+    uintptr_t base = (uintptr_t)ptr & ~(uintptr_t)(bytes - 1u);
+    return (struct slab *)(base + bytes - sizeof(struct slab));
+}
+
+/**
+ * Allocate an object from the size class that fits `size`.
+ *
+ * @param size Requested size in bytes; must be 1 .. SLAB_MAX_SIZE.
+ * @returns Pointer aligned to the class size, or NULL if the size is out of range or no slab could be created.
+ */
+void *slab_alloc(size_t size)
+{
+    if (!size || size > SLAB_MAX_SIZE) {
+        return 0;
+    }
+
+    if (!slab_ready) {
+        slab_init();
+    }
+
+    size_t index = slab_class_index(size);
+    struct slab_class *cls = &classes[index];
+    struct slab *slab = cls->partial;
+    if (slab) {
+        ++cls->hits;
+    } else {
+        ++cls->misses;
+        slab = slab_create(cls, index);
+        if (!slab) {
+            return 0;
+        }
+    }
+
+    struct slab_free_object *object = slab->free_objects;
+    slab->free_objects = object->next;
+    ++slab->in_use;
+    ++cls->objects_in_use;
+    if (slab->in_use == slab->capacity) {
+        slab_list_remove(cls, slab);
+    }
+    return object;
+}
+
+/**
+ * Return an object to its slab.
+ *
+ * An emptied slab goes back to the page allocator unless it is the class's
+ * only partial slab, which is kept to absorb alloc/free ping-pong.
+ *
+ * @param ptr Object address.
+ * @returns `true` if `ptr` was a slab object and has been released, `false` if it does not belong to a slab.
+ */
+bool slab_free(void *ptr)
+{
+    struct slab *slab = slab_lookup(ptr);
+    if (!slab) {
+        return false;
+    }
+
+    struct slab_class *cls = &classes[slab->class_index];
+    struct slab_free_object *object = (struct slab_free_object *)ptr;
+    object->next = slab->free_objects;
+    slab->free_objects = object;
+
+    if (slab->in_use == slab->capacity) {
+        slab_list_push(cls, slab);
+    }
+    --slab->in_use;
+    --cls->objects_in_use;
+
+    if (!slab->in_use && (slab->prev || slab->next)) {
+        slab_list_remove(cls, slab);
+        cls->objects_total -= slab->capacity;
+        --cls->slab_count;
+        uintptr_t base = (uintptr_t)ptr & ~(uintptr_t)(slab_bytes(cls) - 1u);
+        page_free((void *)base, cls->order);
+    }
+    return true;
+}
+
+/**
+ * Report the usable size of a slab object.
+ *
+ * @returns The class size of the object, or 0 if `ptr` does not belong to a slab.
+ */
+size_t slab_object_size(const void *ptr)
+{
+    const struct slab *slab = slab_lookup(ptr);
+    return slab ? classes[slab->class_index].object_size : 0;
+}
+
+/**
+ * Populate counters for one size class.
+ *
+ * @param class_index Class index (0 .. SLAB_CLASS_COUNT - 1).
+ * @param stats Structure to fill; must not be NULL.
+ * @returns `true` on success, `false` if the index is out of range or `stats` is NULL.
+ */
+bool slab_get_stats(size_t class_index, struct slab_class_stats *stats)
+{
+    if (class_index >= SLAB_CLASS_COUNT || !stats) {
+        return false;
+    }
+
+    if (!slab_ready) {
+        slab_init();
+    }
+
+    const struct slab_class *cls = &classes[class_index];
+    stats->object_size = cls->object_size;
+    stats->hits = cls->hits;
+    stats->misses = cls->misses;
+    stats->objects_in_use = cls->objects_in_use;
+    stats->objects_total = cls->objects_total;
+    stats->slab_count = cls->slab_count;
+    return true;
+}
@@ -1,11 +1,260 @@
+#include <lux/apic.h>
+#include <lux/cpu.h>
+#include <lux/event.h>
+#include <lux/idle.h>
+#include <lux/io.h>
+#include <lux/irq.h>
+#include <lux/profile.h>
 #include <lux/time.h>
+#include <lux/timer.h>
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
+#define PIT_FREQUENCY_HZ  1193182u
+#define PIT_CHANNEL0_DATA 0x40u
+#define PIT_COMMAND       0x43u
+#define PIT_DIVISOR       ((PIT_FREQUENCY_HZ + CLOCK_HZ / 2u) / CLOCK_HZ)
+
+#define NS_PER_SECOND     1000000000ull
+#define NS_PER_MS         1000000ull
+#define NS_PER_TICK       (NS_PER_SECOND / CLOCK_HZ)
+
+/* Longest tickless idle period; the 16-bit PIT counter caps one-shots at about 54.9 ms anyway. */
+#define CLOCK_NOHZ_MAX_NS NS_PER_SECOND
+#define PIT_ONESHOT_MAX   0xFFFFu
+
 #define SLEEP_TICK_ITERATIONS 8000u
 
+static volatile uint64_t clock_tick_count;
+static uint64_t clock_last_cycles;
+static bool clock_running;
+
+/* ns = (cycles * clock_tsc_mult) >> clock_tsc_shift; mult is 0 while the TSC is uncalibrated. */
+static uint32_t clock_tsc_mult;
+static uint32_t clock_tsc_shift;
+static uint64_t clock_tsc_base;
+static bool clock_use_tsc;
+
+static bool clock_nohz; /* the periodic tick is stopped for the current idle period */
+
+/**
+ * Derive the cycles-to-nanoseconds factor from the calibrated TSC frequency.
+ *
+ * Picks the largest shift (at most 32) whose multiplier still fits 32 bits,
+ * which keeps the conversion within one part in 2^31 for any TSC above 1 MHz.
+ *
+ * @param khz TSC frequency in kHz; `0` leaves the TSC unused.
+ */
+static void clock_tsc_setup(uint32_t khz)
+{
+    clock_tsc_mult = 0;
+    if (!khz) {
+        return;
+    }
+
+    for (uint32_t shift = 32; shift > 0; --shift) {
+        uint64_t mult = ((uint64_t)NS_PER_MS << shift) / khz;
+        if (mult <= 0xFFFFFFFFull) {
+            clock_tsc_mult = (uint32_t)mult;
+            clock_tsc_shift = shift;
+            return;
+        }
+    }
+}
+
+/**
+ * Count one IRQ0 tick, give the sampling profiler its chance to record the
+ * interrupted EIP, post EVENT_TIMER_TICK if anyone listens, and kick the timer
+ * softirq once the earliest timer is due. Runs in interrupt context with
+ * interrupts disabled.
+ *
+ * @param irq Unused.
+ * @param context Unused.
+ */
+static void clock_irq(unsigned int irq, void *context)
+{
+    (void)irq;
+    (void)context;
+    clock_tick_count = clock_tick_count + 1u;
+    profile_tick(irq_current_frame());
+    if (event_has_subscribers(EVENT_TIMER_TICK)) {
+        event_post(EVENT_TIMER_TICK, (uint32_t)clock_ticks());
+    }
+    timer_check();
+}
+
+/**
+ * Program PIT channel 0 as the CLOCK_HZ rate generator.
+ */
+static void clock_pit_periodic(void)
+{
+    outb(PIT_COMMAND, 0x34u); /* channel 0, lobyte/hibyte, mode 2, binary */
+    outb(PIT_CHANNEL0_DATA, (uint8_t)(PIT_DIVISOR & 0xFFu));
+    outb(PIT_CHANNEL0_DATA, (uint8_t)((PIT_DIVISOR >> 8) & 0xFFu));
+}
+
+/**
+ * Program PIT channel 0 to raise IRQ0 once after `ns`; the output then stays
+ * high until the channel is reprogrammed.
+ *
+ * @param ns Delay in nanoseconds; clamped to the 16-bit counter (about 54.9 ms).
+ */
+static void clock_pit_oneshot(uint64_t ns)
+{
+    uint64_t count = (ns * PIT_FREQUENCY_HZ) / NS_PER_SECOND;
+    if (!count) {
+        count = 1;
+    } else if (count > PIT_ONESHOT_MAX) {
+        count = PIT_ONESHOT_MAX;
+    }
+    outb(PIT_COMMAND, 0x30u); /* channel 0, lobyte/hibyte, mode 0 (interrupt on terminal count) */
+    outb(PIT_CHANNEL0_DATA, (uint8_t)(count & 0xFFu));
+    outb(PIT_CHANNEL0_DATA, (uint8_t)((count >> 8) & 0xFFu));
+}
+
+/**
+ * Program PIT channel 0 in mode 2 (rate generator) with the CLOCK_HZ divisor and claim IRQ0.
+ */
+void clock_init(void)
+{
+    uint32_t flags = cpu_irq_save();
+    clock_pit_periodic();
+    clock_tick_count = 0;
+    clock_last_cycles = 0;
+    clock_running = true;
+    timer_init();
+    irq_register(IRQ_TIMER, clock_irq, NULL);
+    cpu_irq_restore(flags);
+
+    clock_tsc_setup(tsc_khz());
+    clock_use_tsc = clock_tsc_mult && tsc_constant_rate();
+    clock_tsc_base = tsc_read();
+
+    /* The PIT fallback interpolates with the PIT counter, so only a TSC clock may drop the PIT tick. */
+    if (clock_use_tsc && apic_enabled()) {
+        apic_timer_start(CLOCK_HZ);
+    }
+}
+
+/**
+ * Convert TSC cycles to nanoseconds with a 64x32-bit multiply split into two 32x32 halves.
+ *
+ * @param cycles Cycle count, typically a clock_cycles() difference.
+ * @returns Nanoseconds, or `0` if the TSC frequency is unknown.
+ */
+uint64_t clock_cycles_to_ns(uint64_t cycles)
+{
+    if (!clock_tsc_mult) {
+        return 0;
+    }
+
+    uint64_t low = (uint64_t)(uint32_t)cycles * clock_tsc_mult;
+    uint64_t high = (cycles >> 32) * clock_tsc_mult;
+    return (high << (32u - clock_tsc_shift)) + (low >> clock_tsc_shift);
+}
+
+/**
+ * Name the source clock_ns() reads.
+ *
+ * @returns "tsc" when the TSC backs the clock, "pit" otherwise.
+ */
+const char *clock_source(void)
+{
+    return clock_use_tsc ? "tsc" : "pit";
+}
+
+
+/**
+ * Count elapsed tick periods.
+ *
+ * With a TSC clock the idle path may stop the tick, so the count is derived
+ * from clock_ns(); the PIT clock always ticks and reads its 64-bit counter
+ * consistently on a 32-bit CPU.
+ *
+ * @returns Ticks since clock_init().
+ */
+uint64_t clock_ticks(void)
+{
+    if (clock_use_tsc) {
+        return clock_ns() / NS_PER_TICK;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    uint64_t ticks = clock_tick_count;
+    cpu_irq_restore(flags);
+    return ticks;
+}
+
+/**
+ * Count PIT input cycles since clock_init(), combining the tick counter with the live channel 0 count.
+ *
+ * A counter that wrapped after the last IRQ0 was serviced shows up as a pending
+ * request at the interrupt controller; that tick is added here so the result never jumps
+ * backwards. The result is clamped to the last value returned for good measure.
+ *
+ * @returns Elapsed PIT cycles (1193182 per second).
+ */
+static uint64_t clock_pit_cycles(void)
+{
+    uint32_t flags = cpu_irq_save();
+    uint64_t ticks = clock_tick_count;
+
+    outb(PIT_COMMAND, 0x00u); /* latch channel 0 */
+    uint32_t count = inb(PIT_CHANNEL0_DATA);
+    count |= (uint32_t)inb(PIT_CHANNEL0_DATA) << 8;
+    bool pending = irq_pending(IRQ_TIMER);
+
+    uint32_t elapsed = count <= PIT_DIVISOR ? PIT_DIVISOR - count : 0u;
+    if (pending && elapsed < PIT_DIVISOR / 2u) {
+        ++ticks;
+    }
+
+    uint64_t cycles = ticks * PIT_DIVISOR + elapsed;
+    if (cycles < clock_last_cycles) {
+        cycles = clock_last_cycles;
+    }
+    clock_last_cycles = cycles;
+    cpu_irq_restore(flags);
+    return cycles;
+}
+
+/**
+ * Report monotonic time in nanoseconds.
+ *
+ * The TSC path is a single RDTSC plus two multiplies; the PIT fallback needs
+ * port I/O and a 64-bit division per call.
+ *
+ * @returns Nanoseconds since clock_init(), or `0` before it ran.
+ */
+uint64_t clock_ns(void)
+{
+    if (!clock_running) {
+        return 0;
+    }
+    if (clock_use_tsc) {
+        return clock_cycles_to_ns(tsc_read() - clock_tsc_base);
+    }
+
+    uint64_t cycles = clock_pit_cycles();
+    uint64_t seconds = cycles / PIT_FREQUENCY_HZ;
+    uint64_t remainder = cycles % PIT_FREQUENCY_HZ;
+    return seconds * NS_PER_SECOND + (remainder * NS_PER_SECOND) / PIT_FREQUENCY_HZ;
+}
+
+/**
+ * Report monotonic time in milliseconds.
+ *
+ * @returns Milliseconds since clock_init(), or `0` before it ran.
+ */
+uint64_t clock_ms(void)
+{
+    return clock_ns() / NS_PER_MS;
+}
+
 /**
- * Busy-wait for one calibrated timing tick.
+ * Busy-wait for roughly one millisecond; only used before the clock runs.
  *
  * Performs a tight loop of SLEEP_TICK_ITERATIONS iterations, issuing a processor
  * PAUSE hint on each iteration to consume time while reducing CPU contention.
@@ -18,16 +267,109 @@ static void busy_wait_tick(void)
 }
 
 /**
- * Block execution for the specified number of milliseconds using a busy-wait loop.
+ * Stop the periodic tick before the idle path halts, if nothing needs it.
  *
- * This function performs a CPU-intensive spin and does not yield the processor
- * or validate the input; timing is approximate and depends on calibration.
+ * The tick stays on with the PIT clocksource (it counts time), while the
+ * profiler samples, or while EVENT_TIMER_TICK has subscribers. Otherwise IRQ0
+ * is reprogrammed as a one-shot for the earliest timer deadline, capped at
+ * CLOCK_NOHZ_MAX_NS (LAPIC timer) or the PIT's 16-bit counter. Call with
+ * interrupts disabled, right before `sti; hlt`.
+ *
+ * @returns `true` if the tick was stopped; clock_idle_exit() must follow the halt.
+ */
+bool clock_idle_enter(void)
+{
+    if (!clock_running || !clock_use_tsc || profile_active() || event_has_subscribers(EVENT_TIMER_TICK)) {
+        return false;
+    }
+
+    uint64_t now = clock_ns();
+    uint64_t deadline = timer_next_deadline();
+    if (deadline <= now + NS_PER_TICK) {
+        return false;
+    }
+
+    uint64_t delta = deadline - now;
+    if (delta > CLOCK_NOHZ_MAX_NS) {
+        delta = CLOCK_NOHZ_MAX_NS;
+    }
+    if (!apic_timer_oneshot(delta)) {
+        clock_pit_oneshot(delta);
+    }
+    clock_nohz = true;
+    return true;
+}
+
+/**
+ * Restart the periodic tick after a tickless halt; a no-op if the tick ran.
+ */
+void clock_idle_exit(void)
+{
+    uint32_t flags = cpu_irq_save();
+    if (clock_nohz) {
+        if (apic_timer_active()) {
+            apic_timer_periodic();
+        } else {
+            clock_pit_periodic();
+        }
+        clock_nohz = false;
+    }
+    cpu_irq_restore(flags);
+}
+
+/**
+ * Block execution for the specified number of milliseconds, or until `stop` reports a request to give up.
+ *
+ * Arms one wake-up timer for the deadline and idles until it passes, so a
+ * tickless idle halts for the whole sleep instead of waking every tick. The
+ * deadline and `stop` are checked with interrupts disabled, and cpu_idle()
+ * re-enables them atomically with the halt, so an interrupt arriving in between
+ * cannot be missed. Whatever sets the `stop` condition (such as the Ctrl-C
+ * keystroke) must arrive through an interrupt to wake the CPU.
  *
  * @param milliseconds Number of milliseconds to sleep.
+ * @param stop Polled after every wake-up with interrupts disabled; NULL sleeps the full duration.
+ * @returns `true` if the full duration elapsed, `false` if `stop` returned `true` first.
  */
-void sleep_ms(uint32_t milliseconds)
+bool sleep_ms_interruptible(uint32_t milliseconds, bool (*stop)(void))
 {
-    while (milliseconds--) {
-        busy_wait_tick();
+    if (!clock_running || !cpu_interrupts_enabled()) {
+        while (milliseconds--) {
+            if (stop && stop()) {
+                return false;
+            }
+            busy_wait_tick();
+        }
+        return true;
     }
-}
\ No newline at end of file
+
+    uint64_t deadline = clock_ns() + (uint64_t)milliseconds * NS_PER_MS;
+    struct timer wakeup;
+    timer_setup(&wakeup, NULL, NULL);
+    timer_arm(&wakeup, deadline);
+    bool completed = true;
+    for (;;) {
+        cpu_irq_disable();
+        if (stop && stop()) {
+            completed = false;
+            break;
+        }
+        if (clock_ns() >= deadline) {
+            break;
+        }
+        cpu_idle();
+    }
+    cpu_irq_enable();
+    timer_cancel(&wakeup);
+    return completed;
+}
+
+/**
+ * Block execution for the specified number of milliseconds.
+ *
+ * @param milliseconds Number of milliseconds to sleep.
+ */
+void sleep_ms(uint32_t milliseconds)
+{
+    (void)sleep_ms_interruptible(milliseconds, NULL);
+}
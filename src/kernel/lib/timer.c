@@ -0,0 +1,166 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: One-shot kernel timers kept in a deadline-sorted list and expired from a softirq.
+ */
+#include <lux/cpu.h>
+#include <lux/softirq.h>
+#include <lux/time.h>
+#include <lux/timer.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static struct timer *timer_head;
+
+/**
+ * Run every timer whose deadline has passed. Each timer is unlinked before its
+ * callback runs, so a callback may re-arm it.
+ *
+ * @param context Unused.
+ */
+static void timer_softirq(void *context)
+{
+    (void)context;
+
+    for (;;) {
+        uint32_t flags = cpu_irq_save();
+        struct timer *timer = timer_head;
+        if (!timer || timer->deadline > clock_ns()) {
+            cpu_irq_restore(flags);
+            return;
+        }
+        timer_head = timer->next;
+        timer->next = NULL;
+        timer->armed = false;
+        timer_fn_t fn = timer->fn;
+        void *context_arg = timer->context;
+        cpu_irq_restore(flags);
+
+        if (fn) {
+            fn(context_arg);
+        }
+    }
+}
+
+/**
+ * Register the timer softirq. Called from clock_init().
+ */
+void timer_init(void)
+{
+    softirq_register(SOFTIRQ_TIMER, timer_softirq, NULL);
+}
+
+/**
+ * Prepare a timer for use; it starts disarmed.
+ *
+ * @param timer Timer to initialize; ignored if NULL.
+ * @param fn Callback run from the timer softirq, or NULL if the timer only wakes an idle CPU.
+ * @param context Opaque pointer passed to `fn`.
+ */
+void timer_setup(struct timer *timer, timer_fn_t fn, void *context)
+{
+    if (!timer) {
+        return;
+    }
+    timer->deadline = 0;
+    timer->fn = fn;
+    timer->context = context;
+    timer->next = NULL;
+    timer->armed = false;
+}
+
+/**
+ * Unlink a timer from the pending list. Call with interrupts disabled.
+ *
+ * @param timer Timer to remove.
+ * @returns `true` if it was armed.
+ */
+static bool timer_unlink(struct timer *timer)
+{
+    if (!timer->armed) {
+        return false;
+    }
+    for (struct timer **link = &timer_head; *link; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            break;
+        }
+    }
+    timer->next = NULL;
+    timer->armed = false;
+    return true;
+}
+
+/**
+ * Arm (or re-arm) a timer for an absolute clock_ns() deadline.
+ *
+ * The list stays sorted, so the idle path only looks at the head to program
+ * the next one-shot timer interrupt. Timers with equal deadlines fire in arming order.
+ *
+ * @param timer Timer set up with timer_setup().
+ * @param deadline Absolute time in nanoseconds; a deadline in the past fires on the next tick.
+ * @returns `true` on success, `false` if `timer` is NULL.
+ */
+bool timer_arm(struct timer *timer, uint64_t deadline)
+{
+    if (!timer) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    timer_unlink(timer);
+    timer->deadline = deadline;
+    struct timer **link = &timer_head;
+    while (*link && (*link)->deadline <= deadline) {
+        link = &(*link)->next;
+    }
+    timer->next = *link;
+    *link = timer;
+    timer->armed = true;
+    cpu_irq_restore(flags);
+    return true;
+}
+
+/**
+ * Disarm a timer. Its callback will not run unless it is armed again.
+ *
+ * @param timer Timer to cancel.
+ * @returns `true` if the timer was pending, `false` if it was not armed or is NULL.
+ */
+bool timer_cancel(struct timer *timer)
+{
+    if (!timer) {
+        return false;
+    }
+
+    uint32_t flags = cpu_irq_save();
+    bool was_armed = timer_unlink(timer);
+    cpu_irq_restore(flags);
+    return was_armed;
+}
+
+/**
+ * Report the earliest pending deadline.
+ *
+ * @returns Absolute time in nanoseconds, or `TIMER_NO_DEADLINE` if no timer is armed.
+ */
+uint64_t timer_next_deadline(void)
+{
+    uint32_t flags = cpu_irq_save();
+    uint64_t deadline = timer_head ? timer_head->deadline : TIMER_NO_DEADLINE;
+    cpu_irq_restore(flags);
+    return deadline;
+}
+
+/**
+ * Raise the timer softirq if the earliest timer is due. Called from the timer
+ * interrupt with interrupts disabled; the clock is only read while a timer is armed.
+ */
+void timer_check(void)
+{
+    if (timer_head && timer_head->deadline <= clock_ns()) {
+        softirq_raise(SOFTIRQ_TIMER);
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: TSC frequency calibration against the 8254 PIT channel 2 gate.
+ */
+#include <lux/cpu.h>
+#include <lux/io.h>
+#include <lux/tsc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PIT_FREQUENCY_HZ     1193182u
+#define PIT_CHANNEL2_DATA    0x42u
+#define PIT_COMMAND          0x43u
+#define PIT_GATE_PORT        0x61u
+#define PIT_GATE_ENABLE      0x01u
+#define PIT_SPEAKER_ENABLE   0x02u
+#define PIT_CHANNEL2_OUT     0x20u
+#define TSC_CALIBRATE_MS     10u
+#define TSC_CALIBRATE_RUNS   3u
+
+#define CPUID_1_ECX_HYPERVISOR     (1u << 31)
+#define CPUID_80000007_EDX_INVTSC  (1u << 8)
+
+static uint32_t tsc_frequency_khz;
+static bool tsc_calibrated;
+
+/**
+ * Measure how many TSC cycles elapse while PIT channel 2 counts down a fixed interval.
+ *
+ * Programs channel 2 in mode 0 (interrupt on terminal count) with the speaker
+ * disconnected, then spins on the OUT bit exposed through port 0x61.
+ *
+ * @returns Measured TSC frequency in kHz, or `0` if the PIT never signalled.
+ */
+static uint32_t tsc_calibrate_pit(void)
+{
+    const uint32_t latch = (PIT_FREQUENCY_HZ * TSC_CALIBRATE_MS) / 1000u;
+
+    uint8_t gate = inb(PIT_GATE_PORT);
+    outb(PIT_GATE_PORT, (uint8_t)((gate & ~PIT_SPEAKER_ENABLE) | PIT_GATE_ENABLE));
+
+    outb(PIT_COMMAND, 0xB0u); /* channel 2, lobyte/hibyte, mode 0, binary */
+    outb(PIT_CHANNEL2_DATA, (uint8_t)(latch & 0xFFu));
+    outb(PIT_CHANNEL2_DATA, (uint8_t)((latch >> 8) & 0xFFu));
+
+    uint64_t start = tsc_read();
+    uint32_t guard = 0;
+    while (!(inb(PIT_GATE_PORT) & PIT_CHANNEL2_OUT)) {
+        if (++guard == 0x01000000u) {
+            outb(PIT_GATE_PORT, gate);
+            return 0;
+        }
+    }
+    uint64_t end = tsc_read();
+
+    outb(PIT_GATE_PORT, gate);
+    return (uint32_t)((end - start) / TSC_CALIBRATE_MS);
+}
+
+/**
+ * Read CPUID leaf 1, or report that CPUID is missing.
+ *
+ * @param ecx Receives ECX.
+ * @param edx Receives EDX.
+ * @returns `true` if CPUID is available.
+ */
+static bool tsc_cpuid_leaf1(uint32_t *ecx, uint32_t *edx)
+{
+    if (!cpu_has_cpuid()) {
+        return false;
+    }
+
+    uint32_t eax, ebx;
+    cpuid(1, 0, &eax, &ebx, ecx, edx);
+    return true;
+}
+
+/**
+ * Report the TSC frequency, running the PIT calibration on the first call.
+ *
+ * Calibration runs TSC_CALIBRATE_RUNS times and keeps the median, so a single
+ * run stretched by an SMI or a host preemption does not skew the result.
+ *
+ * @returns TSC frequency in kHz, or `0` if the CPU has no TSC or calibration failed.
+ */
+uint32_t tsc_khz(void)
+{
+    if (!tsc_calibrated) {
+        tsc_calibrated = true;
+
+        uint32_t ecx, edx;
+        if (!tsc_cpuid_leaf1(&ecx, &edx) || !(edx & CPUID_1_EDX_TSC)) {
+            return 0;
+        }
+
+        uint32_t runs[TSC_CALIBRATE_RUNS];
+        for (size_t i = 0; i < TSC_CALIBRATE_RUNS; ++i) {
+            uint32_t khz = tsc_calibrate_pit();
+            size_t j = i;
+            for (; j > 0 && runs[j - 1u] > khz; --j) {
+                runs[j] = runs[j - 1u];
+            }
+            runs[j] = khz;
+        }
+        tsc_frequency_khz = runs[TSC_CALIBRATE_RUNS / 2u];
+    }
+    return tsc_frequency_khz;
+}
+
+/**
+ * Check CPUID for an invariant TSC, which ticks at a constant rate across P-, C- and T-states.
+ *
+ * @returns `true` if CPUID.80000007H:EDX[8] is set.
+ */
+bool tsc_invariant(void)
+{
+    if (!cpu_has_cpuid()) {
+        return false;
+    }
+
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(0x80000000u, 0, &eax, &ebx, &ecx, &edx);
+    if (eax < 0x80000007u) {
+        return false;
+    }
+    cpuid(0x80000007u, 0, &eax, &ebx, &ecx, &edx);
+    return (edx & CPUID_80000007_EDX_INVTSC) != 0;
+}
+
+/**
+ * Decide whether the TSC can serve as a clocksource.
+ *
+ * Hypervisors often hide the invariant-TSC bit while still presenting a
+ * constant-rate TSC, so a guest (CPUID.1:ECX[31]) is trusted as well.
+ *
+ * @returns `true` if the TSC is invariant or the kernel runs under a hypervisor.
+ */
+bool tsc_constant_rate(void)
+{
+    uint32_t ecx, edx;
+    if (!tsc_cpuid_leaf1(&ecx, &edx) || !(edx & CPUID_1_EDX_TSC)) {
+        return false;
+    }
+    return tsc_invariant() || (ecx & CPUID_1_ECX_HYPERVISOR) != 0;
+}
@@ -15,6 +15,10 @@ extern const struct shell_command shell_command_touch;
 extern const struct shell_command shell_command_sleep;
 extern const struct shell_command shell_command_printf;
 extern const struct shell_command shell_command_mkdir;
+extern const struct shell_command shell_command_boottime;
+extern const struct shell_command shell_command_uptime;
+extern const struct shell_command shell_command_perf;
+extern const struct shell_command shell_command_irqstat;
 
 /**
  * Provide the table of built-in shell commands.
@@ -39,7 +43,11 @@ const struct shell_command *const *shell_builtin_commands(size_t *count)
         &shell_command_touch,
         &shell_command_mkdir,
         &shell_command_sleep,
-        &shell_command_printf
+        &shell_command_printf,
+        &shell_command_boottime,
+        &shell_command_uptime,
+        &shell_command_perf,
+        &shell_command_irqstat
     };
 
     if (count) {
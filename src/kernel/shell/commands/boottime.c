@@ -0,0 +1,99 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Shell command that prints per-phase boot latency from the boot-time record.
+ */
+#include <lux/boottime.h>
+#include <lux/printf.h>
+#include <lux/shell.h>
+#include <lux/time.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#define BOOTTIME_NAME_WIDTH 14u
+#define BOOTTIME_LINE_MAX   96u
+
+/**
+ * Write a phase label padded with spaces to a fixed column width.
+ *
+ * @param io Shell I/O receiving the label.
+ * @param name Phase label to write.
+ */
+static void boottime_write_name(const struct shell_io *io, const char *name)
+{
+    size_t len = strlen(name);
+    shell_io_write_string(io, "  ");
+    shell_io_write_string(io, name);
+    while (len++ < BOOTTIME_NAME_WIDTH) {
+        shell_io_putc(io, ' ');
+    }
+}
+
+/**
+ * Handle the `boottime` shell command.
+ *
+ * Prints every recorded boot phase with the TSC cycles spent since the previous
+ * recorded phase and the same delta in microseconds, followed by the total time
+ * from the first recorded timestamp to the last one.
+ *
+ * @param argc Unused.
+ * @param argv Unused.
+ * @param io Shell I/O used for output.
+ */
+static void boottime_handler(int argc, char **argv, const struct shell_io *io)
+{
+    (void)argc;
+    (void)argv;
+
+    char line[BOOTTIME_LINE_MAX];
+    uint32_t khz = tsc_khz();
+    snprintf(line, sizeof(line), "Boot timeline (TSC %u.%u MHz%s, clocksource %s):\n", khz / 1000u, (khz % 1000u) / 100u,
+             tsc_invariant() ? ", invariant" : "", clock_source());
+    shell_io_write_string(io, line);
+
+    uint64_t first = 0;
+    uint64_t previous = 0;
+    bool have_previous = false;
+
+    for (int phase = 0; phase < BOOT_PHASE_COUNT; ++phase) {
+        uint64_t stamp = 0;
+        const char *name = boottime_phase_name((enum boot_phase)phase);
+
+        if (!boottime_get((enum boot_phase)phase, &stamp)) {
+            boottime_write_name(io, name);
+            shell_io_write_string(io, "not recorded\n");
+            continue;
+        }
+
+        if (!have_previous) {
+            first = stamp;
+            previous = stamp;
+            have_previous = true;
+            boottime_write_name(io, name);
+            shell_io_write_string(io, "t=0\n");
+            continue;
+        }
+
+        uint64_t delta = stamp - previous;
+        previous = stamp;
+        boottime_write_name(io, name);
+        snprintf(line, sizeof(line), "+%llu cycles  %llu us\n",
+                 (unsigned long long)delta, (unsigned long long)(clock_cycles_to_ns(delta) / 1000u));
+        shell_io_write_string(io, line);
+    }
+
+    if (have_previous) {
+        uint64_t total = previous - first;
+        boottime_write_name(io, "total");
+        snprintf(line, sizeof(line), "%llu cycles  %llu us\n",
+                 (unsigned long long)total, (unsigned long long)(clock_cycles_to_ns(total) / 1000u));
+        shell_io_write_string(io, line);
+    }
+}
+
+const struct shell_command shell_command_boottime = {
+    .name = "boottime",
+    .help = "Show per-phase boot latency",
+    .handler = boottime_handler,
+};
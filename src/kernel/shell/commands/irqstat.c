@@ -0,0 +1,213 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Shell command reporting per-IRQ counters, handler latency histograms, and interrupts-off spans.
+ */
+#include <lux/irq.h>
+#include <lux/ksyms.h>
+#include <lux/printf.h>
+#include <lux/shell.h>
+#include <lux/time.h>
+#include <string.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define IRQSTAT_LINE_MAX 128u
+#define IRQSTAT_BAR_MAX  40u
+
+/* Too large for the shell's stack frame; the shell runs one command at a time. */
+static struct irq_stats irqstat_snapshot;
+
+/**
+ * Format a cycle count as a duration, falling back to raw cycles while the TSC is uncalibrated.
+ *
+ * @param text Destination buffer.
+ * @param size Size of `text`.
+ * @param cycles clock_cycles() difference.
+ */
+static void irqstat_format_cycles(char *text, size_t size, uint64_t cycles)
+{
+    uint64_t ns = clock_cycles_to_ns(cycles);
+    if (!ns && cycles) {
+        snprintf(text, size, "%llu cycles", (unsigned long long)cycles);
+    } else if (ns < 10000u) {
+        snprintf(text, size, "%llu ns", (unsigned long long)ns);
+    } else if (ns < 10000000u) {
+        snprintf(text, size, "%llu.%llu us", (unsigned long long)(ns / 1000u), (unsigned long long)((ns % 1000u) / 100u));
+    } else {
+        snprintf(text, size, "%llu.%llu ms", (unsigned long long)(ns / 1000000u),
+                 (unsigned long long)((ns % 1000000u) / 100000u));
+    }
+}
+
+/**
+ * Parse an IRQ line number.
+ *
+ * @param text Decimal string.
+ * @param irq Receives the line on success.
+ * @returns `true` if `text` is a number below IRQ_LINES, `false` otherwise.
+ */
+static bool irqstat_parse_line(const char *text, unsigned int *irq)
+{
+    if (!text || !*text || strlen(text) > 2u) {
+        return false;
+    }
+
+    unsigned int value = 0;
+    for (size_t i = 0; text[i]; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        value = value * 10u + (unsigned int)(text[i] - '0');
+    }
+    if (value >= IRQ_LINES) {
+        return false;
+    }
+    *irq = value;
+    return true;
+}
+
+/**
+ * Print one row per line that saw interrupts, then the longest interrupts-disabled section.
+ *
+ * @param io Shell I/O used for output.
+ * @param stats Snapshot from irq_get_stats().
+ */
+static void irqstat_print_summary(const struct shell_io *io, const struct irq_stats *stats)
+{
+    char line[IRQSTAT_LINE_MAX];
+    char avg[24];
+    char max[24];
+    bool any = false;
+
+    snprintf(line, sizeof(line), "Interrupts via %s; handler time is dispatch entry to EOI.\n", irq_controller());
+    shell_io_write_string(io, line);
+
+    for (unsigned int irq = 0; irq < IRQ_LINES; ++irq) {
+        if (!stats->counts[irq] && !stats->spurious[irq]) {
+            continue;
+        }
+        any = true;
+
+        uint64_t runs = 0;
+        for (size_t bucket = 0; bucket < IRQ_HIST_BUCKETS; ++bucket) {
+            runs += stats->histogram[irq][bucket];
+        }
+        const char *name = NULL;
+        uint32_t offset = 0;
+        if (!stats->handlers[irq] || !ksym_lookup(stats->handlers[irq], &name, &offset)) {
+            name = stats->handlers[irq] ? "[unknown]" : "[none]";
+        }
+        irqstat_format_cycles(avg, sizeof(avg), runs ? stats->cycles[irq] / runs : 0u);
+        irqstat_format_cycles(max, sizeof(max), stats->max_cycles[irq]);
+        snprintf(line, sizeof(line), "IRQ%u vec 0x%x %s: %llu irqs, %llu spurious, avg %s, max %s\n",
+                 irq, IRQ_VECTOR_BASE + irq, name,
+                 (unsigned long long)stats->counts[irq], (unsigned long long)stats->spurious[irq], avg, max);
+        shell_io_write_string(io, line);
+    }
+    if (!any) {
+        shell_io_write_string(io, "No interrupts since the last reset.\n");
+    }
+
+    if (!stats->irqoff_traced) {
+        shell_io_write_string(io, "Interrupts-off sections: not tracked (build with IRQ_TRACE=1)\n");
+        return;
+    }
+
+    const char *site = NULL;
+    uint32_t offset = 0;
+    irqstat_format_cycles(max, sizeof(max), stats->irqoff_max);
+    if (stats->irqoff_site && ksym_lookup(stats->irqoff_site, &site, &offset)) {
+        snprintf(line, sizeof(line), "Longest interrupts-off section: %s in %s+0x%x\n", max, site, (unsigned int)offset);
+    } else {
+        snprintf(line, sizeof(line), "Longest interrupts-off section: %s at 0x%x\n", max, (unsigned int)stats->irqoff_site);
+    }
+    shell_io_write_string(io, line);
+}
+
+/**
+ * Print the handler time histogram of one line with a bar per bucket.
+ *
+ * @param io Shell I/O used for output.
+ * @param stats Snapshot from irq_get_stats().
+ * @param irq Line to show.
+ */
+static void irqstat_print_histogram(const struct shell_io *io, const struct irq_stats *stats, unsigned int irq)
+{
+    char line[IRQSTAT_LINE_MAX];
+    char bound[24];
+    char bar[IRQSTAT_BAR_MAX + 1u];
+
+    const uint32_t *buckets = stats->histogram[irq];
+    uint32_t peak = 0;
+    for (size_t bucket = 0; bucket < IRQ_HIST_BUCKETS; ++bucket) {
+        if (buckets[bucket] > peak) {
+            peak = buckets[bucket];
+        }
+    }
+    if (!peak) {
+        snprintf(line, sizeof(line), "IRQ%u: no interrupts since the last reset.\n", irq);
+        shell_io_write_string(io, line);
+        return;
+    }
+
+    snprintf(line, sizeof(line), "IRQ%u handler time:\n", irq);
+    shell_io_write_string(io, line);
+    for (size_t bucket = 0; bucket < IRQ_HIST_BUCKETS; ++bucket) {
+        if (!buckets[bucket]) {
+            continue;
+        }
+        size_t width = (size_t)(((uint64_t)buckets[bucket] * IRQSTAT_BAR_MAX + peak - 1u) / peak);
+        memset(bar, '#', width);
+        bar[width] = '\0';
+
+        bool last = bucket == IRQ_HIST_BUCKETS - 1u;
+        uint32_t shift = IRQ_HIST_SHIFT + (uint32_t)bucket + (last ? 0u : 1u);
+        irqstat_format_cycles(bound, sizeof(bound), 1ull << shift);
+        snprintf(line, sizeof(line), "  %s %s: %u %s\n", last ? ">=" : "< ", bound, (unsigned int)buckets[bucket], bar);
+        shell_io_write_string(io, line);
+    }
+}
+
+/**
+ * Handle the `irqstat` shell command.
+ *
+ * Without arguments it lists every line's interrupt count, average and worst
+ * handler time, and the longest interrupts-disabled section in IRQ_TRACE=1
+ * builds. `irqstat <irq>` shows that line's handler time histogram and
+ * `irqstat reset` starts a new measurement.
+ *
+ * @param argc Number of arguments.
+ * @param argv Argument vector.
+ * @param io Shell I/O used for output.
+ */
+static void irqstat_handler(int argc, char **argv, const struct shell_io *io)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        irq_reset_stats();
+        return;
+    }
+
+    unsigned int irq = 0;
+    if (argc > 1 && !irqstat_parse_line(argv[1], &irq)) {
+        shell_io_write_string(io, "Usage: irqstat [irq] | reset\n");
+        return;
+    }
+
+    if (!irq_get_stats(&irqstat_snapshot)) {
+        return;
+    }
+    if (argc > 1) {
+        irqstat_print_histogram(io, &irqstat_snapshot, irq);
+    } else {
+        irqstat_print_summary(io, &irqstat_snapshot);
+    }
+}
+
+const struct shell_command shell_command_irqstat = {
+    .name = "irqstat",
+    .help = "Show per-IRQ counts, handler latency, and interrupts-off spans",
+    .handler = irqstat_handler,
+};
@@ -1,6 +1,6 @@
+#include <lux/arena.h>
 #include <lux/fs.h>
 #include <lux/keyboard.h>
-#include <lux/memory.h>
 #include <lux/printf.h>
 #include <lux/shell.h>
 #include <lux/tty.h>
@@ -12,6 +12,7 @@
 #define LESS_CTRL_C ((char)0x03)
 #define LESS_READ_CHUNK 512u
 #define LESS_STATUS_BUFFER 128u
+#define LESS_INITIAL_LINES 64u
 
 struct less_document {
     char *data;
@@ -59,8 +60,8 @@ static void less_print_error(const struct shell_io *io, const char *subject, con
  * the number of bytes read. On failure an error message is written to `io`.
  *
  * @param path Path to the file to load.
- * @param out_data Pointer that receives the allocated buffer on success; the
- *                 caller is responsible for freeing it.
+ * @param out_data Pointer that receives the buffer on success; it is allocated
+ *                 from the command's arena and released with it.
  * @param out_len  Pointer that receives the number of bytes read (excluding the
  *                 terminating NUL) on success.
  * @param io       Shell I/O used to report errors.
@@ -90,8 +91,9 @@ static bool less_load_file(const char *path, char **out_data, size_t *out_len, c
         return false;
     }
 
+    struct arena *arena = io ? io->arena : 0;
     size_t capacity = stats.size + 1u;
-    char *buffer = (char *)malloc(capacity ? capacity : 1u);
+    char *buffer = (char *)arena_alloc(arena, capacity ? capacity : 1u);
     if (!buffer) {
         shell_io_write_string(io, "less: out of memory\n");
         return false;
@@ -106,7 +108,6 @@ static bool less_load_file(const char *path, char **out_data, size_t *out_len, c
 
         size_t bytes_read = 0;
         if (!fs_read(resolved, offset, buffer + offset, chunk, &bytes_read)) {
-            free(buffer);
             less_print_error(io, path, "read error");
             return false;
         }
@@ -118,6 +119,10 @@ static bool less_load_file(const char *path, char **out_data, size_t *out_len, c
         offset += bytes_read;
     }
 
+    if (offset < stats.size) {
+        buffer = (char *)arena_resize(arena, buffer, capacity, offset + 1u);
+    }
+
     buffer[offset] = '\0';
     *out_data = buffer;
     *out_len = offset;
@@ -129,7 +134,7 @@ static bool less_load_file(const char *path, char **out_data, size_t *out_len, c
  *
  * Allocates memory to hold the input from `io->input`, copies the bytes, appends a
  * terminating NUL, and returns the buffer and length via the output parameters.
- * The caller is responsible for freeing the returned buffer.
+ * The buffer is allocated from the command's arena.
  *
  * @param io Shell I/O structure containing an input buffer to copy.
  * @param out_data Pointer to receive the allocated, NUL-terminated buffer on success.
@@ -143,7 +148,7 @@ static bool less_copy_input(const struct shell_io *io, char **out_data, size_t *
     }
 
     size_t length = io->input_len;
-    char *buffer = (char *)malloc(length + 1u);
+    char *buffer = (char *)arena_alloc(io->arena, length + 1u);
     if (!buffer) {
         shell_io_write_string(io, "less: out of memory\n");
         return false;
@@ -161,19 +166,21 @@ static bool less_copy_input(const struct shell_io *io, char **out_data, size_t *
  *
  * This function allocates and assigns doc->lines, replaces carriage returns and newline characters
  * in doc->data with NUL ('\0'), and sets doc->line_count and doc->lines to point at the start of each line.
- * The caller is responsible for freeing doc->lines and the original doc->data when no longer needed.
+ * The line array is the arena's most recent allocation, so it grows geometrically and is trimmed
+ * to the final count in place.
  *
  * @param doc Pointer to a less_document whose data buffer contains the text to split; doc->data must be non-NULL.
+ * @param arena Arena the line array is allocated from.
  * @return `true` if lines were prepared and doc->lines populated successfully, `false` on invalid input or allocation failure.
  */
-static bool less_prepare_lines(struct less_document *doc)
+static bool less_prepare_lines(struct less_document *doc, struct arena *arena)
 {
     if (!doc || !doc->data) {
         return false;
     }
 
-    size_t capacity = (doc->length ? doc->length : 1u) + 1u;
-    doc->lines = (char **)malloc(capacity * sizeof(char *));
+    size_t capacity = LESS_INITIAL_LINES;
+    doc->lines = (char **)arena_alloc(arena, capacity * sizeof(char *));
     if (!doc->lines) {
         return false;
     }
@@ -189,6 +196,15 @@ static bool less_prepare_lines(struct less_document *doc)
 
         if (doc->data[i] == '\n') {
             doc->data[i] = '\0';
+            if (count == capacity) {
+                char **lines = (char **)arena_resize(arena, doc->lines, capacity * sizeof(char *),
+                                                     capacity * 2u * sizeof(char *));
+                if (!lines) {
+                    return false;
+                }
+                doc->lines = lines;
+                capacity *= 2u;
+            }
             if (i + 1u < doc->length) {
                 doc->lines[count++] = &doc->data[i + 1u];
             } else {
@@ -202,6 +218,10 @@ static bool less_prepare_lines(struct less_document *doc)
         count = 1;
     }
 
+    if (count < capacity) {
+        doc->lines = (char **)arena_resize(arena, doc->lines, capacity * sizeof(char *), count * sizeof(char *));
+    }
+
     doc->line_count = count;
     return true;
 }
@@ -268,7 +288,7 @@ static void less_render_page(const struct less_document *doc, size_t top_line, s
 /**
  * Waits until a keyboard character is available or the shell requests stop.
  *
- * Blocks by polling for input while checking for a shell stop request.
+ * Idles between checks, waking on the keyboard IRQ (which also delivers Ctrl-C).
  *
  * @returns The character read from the keyboard, or `0` if a shell stop was requested.
  */
@@ -282,6 +302,7 @@ static char less_wait_key(void)
         if (keyboard_poll_char(&symbol)) {
             break;
         }
+        keyboard_wait();
     }
     return symbol;
 }
@@ -388,7 +409,8 @@ static void less_view_document(struct less_document *doc)
  * file; otherwise it reads from the shell's input buffer. If neither source is
  * available, usage information is written to the shell. Errors (file access,
  * read failures, or out-of-memory) are reported to the shell. The pager runs
- * until the user quits, after which all allocated memory is freed.
+ * until the user quits; its buffers live in the command's arena and are
+ * released by the shell when the command line finishes.
  *
  * @param argc Number of command-line arguments; if >= 2 the second argument is treated as the file path to view.
  * @param argv Command-line argument array.
@@ -432,16 +454,12 @@ static void less_handler(int argc, char **argv, const struct shell_io *io)
         .label = label
     };
 
-    if (!less_prepare_lines(&doc)) {
+    if (!less_prepare_lines(&doc, io->arena)) {
         shell_io_write_string(io, "less: out of memory\n");
-        free(data);
         return;
     }
 
     less_view_document(&doc);
-
-    free(doc.lines);
-    free(doc.data);
 }
 
 const struct shell_command shell_command_less = {
@@ -1,5 +1,9 @@
+#include <lux/boot.h>
+#include <lux/ksyms.h>
 #include <lux/memory.h>
+#include <lux/printf.h>
 #include <lux/shell.h>
+#include <string.h>
 
 /**
  * Write a non-negative integer value to the shell IO as ASCII decimal digits.
@@ -48,19 +52,130 @@ static void io_write_line(const struct shell_io *io, const char *label, size_t v
     shell_io_putc(io, '\n');
 }
 
+/**
+ * Print the physical memory map handed over by the loader.
+ *
+ * @param io Shell I/O to which the output is written.
+ */
+static void meminfo_print_map(const struct shell_io *io)
+{
+    const struct boot_info *boot = boot_info_get();
+    char line[96];
+
+    snprintf(line, sizeof(line), "Physical memory map (%s):\n", boot_loader_name(boot->loader));
+    shell_io_write_string(io, line);
+
+    if (!boot->mmap_count) {
+        shell_io_write_string(io, "  No memory map provided by the loader.\n");
+        return;
+    }
+
+    for (size_t i = 0; i < boot->mmap_count; ++i) {
+        const struct boot_mmap_entry *entry = &boot->mmap[i];
+        snprintf(line, sizeof(line), "  0x%llx-0x%llx %s (%llu KiB)\n",
+                 (unsigned long long)entry->base,
+                 (unsigned long long)(entry->base + entry->length - 1u),
+                 boot_mmap_type_name(entry->type),
+                 (unsigned long long)(entry->length / 1024u));
+        shell_io_write_string(io, line);
+    }
+
+    snprintf(line, sizeof(line), "  Available: %llu KiB\n",
+             (unsigned long long)(boot_info_available_bytes() / 1024u));
+    shell_io_write_string(io, line);
+}
+
+/**
+ * Print the allocation profile of a kernel built with HEAP_PROFILE=1.
+ *
+ * Shows malloc/free latency percentiles in TSC cycles, the busiest call sites
+ * and the distribution of request sizes.
+ *
+ * @param io Shell I/O to which the output is written.
+ */
+static void meminfo_print_profile(const struct shell_io *io)
+{
+    struct heap_profile profile;
+    char line[96];
+
+    if (!heap_get_profile(&profile)) {
+        shell_io_write_string(io, "Allocation profiling is not enabled; rebuild with make HEAP_PROFILE=1.\n");
+        return;
+    }
+
+    shell_io_write_string(io, "Allocation latency (TSC cycles):\n");
+    snprintf(line, sizeof(line), "  malloc: %u calls, p50 %llu, p99 %llu\n",
+             (unsigned int)profile.malloc_calls,
+             (unsigned long long)profile.malloc_p50,
+             (unsigned long long)profile.malloc_p99);
+    shell_io_write_string(io, line);
+    snprintf(line, sizeof(line), "  free  : %u calls, p50 %llu, p99 %llu\n",
+             (unsigned int)profile.free_calls,
+             (unsigned long long)profile.free_p50,
+             (unsigned long long)profile.free_p99);
+    shell_io_write_string(io, line);
+
+    shell_io_write_string(io, "Top call sites (caller: allocs/frees, bytes, avg cycles):\n");
+    for (size_t i = 0; i < profile.site_count; ++i) {
+        const struct heap_profile_site *site = &profile.sites[i];
+        size_t calls = site->allocations + site->frees;
+        const char *symbol;
+        uint32_t offset;
+        if (ksym_lookup((uint32_t)site->caller, &symbol, &offset)) {
+            snprintf(line, sizeof(line), "  %s+0x%x: ", symbol, (unsigned int)offset);
+        } else {
+            snprintf(line, sizeof(line), "  %p: ", (void *)site->caller);
+        }
+        shell_io_write_string(io, line);
+        snprintf(line, sizeof(line), "%u/%u, %u bytes, %llu\n",
+                 (unsigned int)site->allocations,
+                 (unsigned int)site->frees,
+                 (unsigned int)site->bytes,
+                 (unsigned long long)(calls ? site->cycles / calls : 0u));
+        shell_io_write_string(io, line);
+    }
+    if (profile.untracked_calls) {
+        io_write_line(io, "  Untracked calls: ", profile.untracked_calls, 0);
+    }
+
+    shell_io_write_string(io, "Request sizes:\n");
+    for (size_t i = 0; i < HEAP_PROFILE_SIZE_CLASSES; ++i) {
+        if (!profile.size_classes[i]) {
+            continue;
+        }
+        if (i + 1u < HEAP_PROFILE_SIZE_CLASSES) {
+            snprintf(line, sizeof(line), "  <= %u bytes: %u\n",
+                     (unsigned int)(8u << i),
+                     (unsigned int)profile.size_classes[i]);
+        } else {
+            snprintf(line, sizeof(line), "  larger: %u\n", (unsigned int)profile.size_classes[i]);
+        }
+        shell_io_write_string(io, line);
+    }
+}
+
 /**
  * Handle the `meminfo` shell command by printing kernel heap statistics to the given shell I/O.
  *
  * Queries the kernel heap statistics and writes a human-readable summary (total, used, free,
- * largest free block, allocation count, and free block count). If statistics cannot be retrieved,
- * an error message is written instead.
+ * largest free block, allocation count, and free block count) followed by the page allocator's
+ * managed and free memory and per-class slab counters. If heap statistics cannot be retrieved,
+ * an error message is written instead. With `--map`, prints the loader's physical memory map instead;
+ * with `--profile`, prints the allocation profile of a profiling build.
  *
  * @param io Shell I/O to which the output is written.
  */
 static void meminfo_handler(int argc, char **argv, const struct shell_io *io)
 {
-    (void)argc;
-    (void)argv;
+    if (argc > 1 && strcmp(argv[1], "--map") == 0) {
+        meminfo_print_map(io);
+        return;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--profile") == 0) {
+        meminfo_print_profile(io);
+        return;
+    }
 
     struct heap_stats stats;
     if (!heap_get_stats(&stats)) {
@@ -75,10 +190,35 @@ static void meminfo_handler(int argc, char **argv, const struct shell_io *io)
     io_write_line(io, "  Largest free block: ", stats.largest_free_block, " bytes");
     io_write_line(io, "  Allocations: ", stats.allocation_count, 0);
     io_write_line(io, "  Free blocks: ", stats.free_block_count, 0);
+
+    struct page_stats pages;
+    if (page_get_stats(&pages)) {
+        shell_io_write_string(io, "Physical pages:\n");
+        io_write_line(io, "  Managed: ", pages.total_pages * (PAGE_SIZE / 1024u), " KiB");
+        io_write_line(io, "  Free   : ", pages.free_pages * (PAGE_SIZE / 1024u), " KiB");
+        io_write_line(io, "  Reserved for heap window: ", pages.reserved_pages * (PAGE_SIZE / 1024u), " KiB");
+    }
+
+    shell_io_write_string(io, "Slab classes (size: in-use/capacity, slabs, hits, misses):\n");
+    for (size_t i = 0; i < SLAB_CLASS_COUNT; ++i) {
+        struct slab_class_stats slab;
+        if (!slab_get_stats(i, &slab) || (!slab.hits && !slab.misses)) {
+            continue;
+        }
+        char line[96];
+        snprintf(line, sizeof(line), "  %u: %u/%u, %u slabs, %u hits, %u misses\n",
+                 (unsigned int)slab.object_size,
+                 (unsigned int)slab.objects_in_use,
+                 (unsigned int)slab.objects_total,
+                 (unsigned int)slab.slab_count,
+                 (unsigned int)slab.hits,
+                 (unsigned int)slab.misses);
+        shell_io_write_string(io, line);
+    }
 }
 
 const struct shell_command shell_command_meminfo = {
     .name = "meminfo",
-    .help = "Show kernel heap statistics",
+    .help = "Show kernel heap statistics (--map: physical memory map, --profile: allocation profile)",
     .handler = meminfo_handler,
 };
\ No newline at end of file
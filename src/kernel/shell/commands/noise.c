@@ -31,13 +31,7 @@ static uint32_t noise_rand(void) {
  * @returns `true` if the full frame delay completed without an interrupt, `false` otherwise.
  */
 static bool noise_delay(void) {
-    for (uint32_t i = 0; i < NOISE_FRAME_DELAY_MS; ++i) {
-        if (shell_command_should_stop()) {
-            return false;
-        }
-        sleep_ms(1);
-    }
-    return true;
+    return sleep_ms_interruptible(NOISE_FRAME_DELAY_MS, shell_command_should_stop);
 }
 
 /**
@@ -0,0 +1,190 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Shell command controlling the sampling profiler and listing the hottest functions.
+ */
+#include <lux/ksyms.h>
+#include <lux/printf.h>
+#include <lux/profile.h>
+#include <lux/shell.h>
+#include <lux/time.h>
+#include <string.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PERF_TOP_DEFAULT 10u
+#define PERF_TOP_MAX     32u
+#define PERF_LINE_MAX    128u
+
+/**
+ * Parse a NUL-terminated decimal string into a positive 32-bit integer.
+ *
+ * @param text ASCII digits to parse.
+ * @param value Receives the parsed value on success.
+ * @returns `true` if `text` is a decimal number between 1 and 0xFFFFFFFF, `false` otherwise.
+ */
+static bool perf_parse_positive(const char *text, uint32_t *value)
+{
+    if (!text || !*text) {
+        return false;
+    }
+
+    uint32_t result = 0;
+    for (size_t i = 0; text[i]; ++i) {
+        if (text[i] < '0' || text[i] > '9') {
+            return false;
+        }
+        uint32_t digit = (uint32_t)(text[i] - '0');
+        if (result > (0xFFFFFFFFu - digit) / 10u) {
+            return false;
+        }
+        result = result * 10u + digit;
+    }
+
+    if (!result) {
+        return false;
+    }
+    *value = result;
+    return true;
+}
+
+/**
+ * Print whether the profiler runs, its rate, and how many samples it holds.
+ *
+ * @param io Shell I/O used for output.
+ * @param stats Current profiler state.
+ */
+static void perf_print_status(const struct shell_io *io, const struct profile_stats *stats)
+{
+    char line[PERF_LINE_MAX];
+    snprintf(line, sizeof(line), "profiler %s, %u Hz, %llu samples (%u kept)%s\n",
+             stats->running ? "running" : "stopped",
+             (unsigned int)(CLOCK_HZ / stats->period),
+             (unsigned long long)stats->samples,
+             (unsigned int)stats->stored,
+             stats->frames ? ", with call stacks" : "");
+    shell_io_write_string(io, line);
+}
+
+/**
+ * Format a share of the kept samples as a percentage with one decimal.
+ *
+ * @param line Destination buffer.
+ * @param size Size of `line`.
+ * @param count Samples attributed to a symbol.
+ * @param stored Total samples kept.
+ */
+static void perf_format_percent(char *line, size_t size, uint32_t count, uint32_t stored)
+{
+    uint32_t permille = (uint32_t)(((uint64_t)count * 1000u) / stored);
+    snprintf(line, size, "%u.%u%%", (unsigned int)(permille / 10u), (unsigned int)(permille % 10u));
+}
+
+/**
+ * List the functions with the most samples, `perf top` style.
+ *
+ * @param io Shell I/O used for output.
+ * @param limit Maximum number of functions to list.
+ */
+static void perf_print_top(const struct shell_io *io, uint32_t limit)
+{
+    struct profile_stats stats;
+    struct profile_entry entries[PERF_TOP_MAX];
+    char line[PERF_LINE_MAX];
+    char self[16];
+    char total[16];
+
+    if (!profile_get_stats(&stats)) {
+        return;
+    }
+    perf_print_status(io, &stats);
+
+    size_t count = profile_top(entries, limit < PERF_TOP_MAX ? limit : PERF_TOP_MAX);
+    if (!count) {
+        shell_io_write_string(io, "No samples; run 'perf start' and exercise the system first.\n");
+        return;
+    }
+
+    shell_io_write_string(io, stats.frames ? "self  total  samples  function\n" : "self  samples  function\n");
+    for (size_t i = 0; i < count; ++i) {
+        const char *name = ksym_name(entries[i].symbol);
+        perf_format_percent(self, sizeof(self), entries[i].self, stats.stored);
+        if (stats.frames) {
+            perf_format_percent(total, sizeof(total), entries[i].total, stats.stored);
+            snprintf(line, sizeof(line), "%s  %s  %u  %s\n", self, total,
+                     (unsigned int)entries[i].self, name ? name : "[unknown]");
+        } else {
+            snprintf(line, sizeof(line), "%s  %u  %s\n", self,
+                     (unsigned int)entries[i].self, name ? name : "[unknown]");
+        }
+        shell_io_write_string(io, line);
+    }
+}
+
+/**
+ * Handle the `perf` shell command.
+ *
+ * `perf start [hz]` samples the interrupted EIP on the timer interrupt (default
+ * CLOCK_HZ), `perf stop` pauses, `perf reset` drops the samples, and
+ * `perf top [n]` lists the n hottest functions. Without arguments it prints the
+ * profiler state.
+ *
+ * @param argc Number of arguments.
+ * @param argv Argument vector.
+ * @param io Shell I/O used for output.
+ */
+static void perf_handler(int argc, char **argv, const struct shell_io *io)
+{
+    struct profile_stats stats;
+    uint32_t value = 0;
+
+    if (argc < 2) {
+        if (profile_get_stats(&stats)) {
+            perf_print_status(io, &stats);
+        }
+        shell_io_write_string(io, "Usage: perf start [hz] | stop | reset | top [count]\n");
+        return;
+    }
+
+    if (strcmp(argv[1], "start") == 0) {
+        uint32_t hz = CLOCK_HZ;
+        if (argc > 2 && (!perf_parse_positive(argv[2], &hz) || hz > CLOCK_HZ)) {
+            shell_io_write_string(io, "perf: rate must be between 1 and 1000 Hz\n");
+            return;
+        }
+        if (!profile_start(CLOCK_HZ / hz)) {
+            shell_io_write_string(io, "perf: out of memory for the sample buffer\n");
+        }
+        return;
+    }
+
+    if (strcmp(argv[1], "stop") == 0) {
+        profile_stop();
+        return;
+    }
+
+    if (strcmp(argv[1], "reset") == 0) {
+        profile_reset();
+        return;
+    }
+
+    if (strcmp(argv[1], "top") == 0) {
+        value = PERF_TOP_DEFAULT;
+        if (argc > 2 && !perf_parse_positive(argv[2], &value)) {
+            shell_io_write_string(io, "perf: invalid count\n");
+            return;
+        }
+        perf_print_top(io, value);
+        return;
+    }
+
+    shell_io_write_string(io, "Usage: perf start [hz] | stop | reset | top [count]\n");
+}
+
+const struct shell_command shell_command_perf = {
+    .name = "perf",
+    .help = "Sample kernel EIPs on the timer and list hot functions",
+    .handler = perf_handler,
+};
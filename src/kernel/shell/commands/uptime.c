@@ -0,0 +1,55 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Shell command that reports time since boot and the share spent idle.
+ */
+#include <lux/idle.h>
+#include <lux/printf.h>
+#include <lux/shell.h>
+#include <lux/time.h>
+
+#include <stdint.h>
+
+#define UPTIME_LINE_MAX 96u
+
+/**
+ * Handle the `uptime` shell command.
+ *
+ * Prints the time since the clock started and how much of it the CPU spent
+ * halted in cpu_idle(), in permille precision.
+ *
+ * @param argc Unused.
+ * @param argv Unused.
+ * @param io Shell I/O used for output.
+ */
+static void uptime_handler(int argc, char **argv, const struct shell_io *io)
+{
+    (void)argc;
+    (void)argv;
+
+    struct idle_stats stats;
+    if (!idle_get_stats(&stats)) {
+        return;
+    }
+
+    uint64_t up_ms = clock_ms();
+    uint64_t idle_ms = clock_cycles_to_ns(stats.idle_cycles) / 1000000u;
+    uint64_t permille = up_ms ? (idle_ms * 1000u) / up_ms : 0u;
+    if (permille > 1000u) {
+        permille = 1000u;
+    }
+
+    char line[UPTIME_LINE_MAX];
+    snprintf(line, sizeof(line), "up %llu.%llu s, idle %llu.%llu s (%llu.%llu%%, %llu halts, %llu tickless)\n",
+             (unsigned long long)(up_ms / 1000u), (unsigned long long)((up_ms % 1000u) / 100u),
+             (unsigned long long)(idle_ms / 1000u), (unsigned long long)((idle_ms % 1000u) / 100u),
+             (unsigned long long)(permille / 10u), (unsigned long long)(permille % 10u),
+             (unsigned long long)stats.halts, (unsigned long long)stats.tickless);
+    shell_io_write_string(io, line);
+}
+
+const struct shell_command shell_command_uptime = {
+    .name = "uptime",
+    .help = "Show time since boot and CPU idle share",
+    .handler = uptime_handler,
+};
@@ -3,9 +3,12 @@
  * Author: Lukas Fend <lukas.fend@outlook.com>
  * Description: Minimal interactive shell handling input, parsing, and built-ins.
  */
+#include <lux/arena.h>
+#include <lux/boottime.h>
 #include <lux/fs.h>
-#include <lux/interrupt.h>
+#include <lux/event.h>
 #include <lux/keyboard.h>
+#include <lux/memory.h>
 #include <lux/shell.h>
 #include <stdbool.h>
 #include <string.h>
@@ -15,7 +18,8 @@
 #define MAX_ARGS 8
 #define HISTORY_SIZE 16
 #define MAX_PIPE_SEGMENTS 4
-#define PIPE_BUFFER_CAPACITY 1024
+#define PIPE_BUFFER_INITIAL_CAPACITY 1024u
+#define PIPE_BUFFER_MAX_CAPACITY (64u * 1024u)
 #define SHELL_CTRL_C 0x03
 
 static char shell_cwd[SHELL_PATH_MAX] = "/home";
@@ -54,8 +58,9 @@ static size_t shell_strnlen(const char *str, size_t max_len)
 }
 
 struct shell_pipe_buffer {
-    char data[PIPE_BUFFER_CAPACITY];
+    char *data; /* heap-allocated on first write, NUL-terminated */
     size_t length;
+    size_t capacity;
     bool overflowed;
 };
 
@@ -72,7 +77,7 @@ static bool shell_interrupt_requested;
 static bool shell_interrupt_announced;
 static int shell_interrupt_subscription = -1;
 static void shell_interrupt_reset_state(void);
-static void shell_interrupt_handler(enum interrupt_signal signal, void *context);
+static void shell_interrupt_handler(const struct event *event, void *context);
 
 static void redraw_prompt_with_buffer(const char *buffer, size_t len);
 static void refresh_prompt_line(const char *buffer, size_t len, size_t previous_len, size_t cursor_pos);
@@ -136,24 +141,60 @@ static void collect_background_input(void)
 /**
  * Initialize a shell pipe buffer to an empty, non-overflowed state.
  *
- * Sets the buffer length to 0, clears the overflow flag, and writes an
- * empty string terminator into the data array.
+ * No memory is allocated until the first write.
  *
  * @param buffer Pointer to the shell_pipe_buffer to initialize.
  */
 static void pipe_buffer_init(struct shell_pipe_buffer *buffer)
 {
+    buffer->data = 0;
     buffer->length = 0;
+    buffer->capacity = 0;
     buffer->overflowed = false;
-    buffer->data[0] = '\0';
+}
+
+/**
+ * Grow a pipe buffer so it can hold at least `needed` bytes plus the terminator.
+ *
+ * Capacity doubles from PIPE_BUFFER_INITIAL_CAPACITY and is capped at
+ * PIPE_BUFFER_MAX_CAPACITY; realloc() extends the buffer in place when the
+ * neighbouring heap block is free. A failed resize leaves the buffer as it was.
+ *
+ * @param buffer Pipe buffer to grow.
+ * @param needed Number of payload bytes the buffer should hold.
+ */
+static void pipe_buffer_reserve(struct shell_pipe_buffer *buffer, size_t needed)
+{
+    if (needed < buffer->capacity) {
+        return;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity : PIPE_BUFFER_INITIAL_CAPACITY;
+    while (capacity <= needed && capacity < PIPE_BUFFER_MAX_CAPACITY) {
+        capacity *= 2u;
+    }
+    if (capacity > PIPE_BUFFER_MAX_CAPACITY) {
+        capacity = PIPE_BUFFER_MAX_CAPACITY;
+    }
+    if (capacity == buffer->capacity) {
+        return;
+    }
+
+    char *data = (char *)realloc(buffer->data, capacity);
+    if (!data) {
+        return;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
 }
 
 /**
  * Append up to `len` bytes from `data` into a shell pipe buffer and null-terminate it.
  *
- * If the input would exceed the buffer's remaining capacity the write is truncated
- * to fit and the buffer's `overflowed` flag is set. The function is a no-op when
- * `context` or `data` is NULL or when `len` is zero.
+ * The buffer grows on demand up to PIPE_BUFFER_MAX_CAPACITY; input beyond that
+ * (or beyond what the heap can provide) is truncated and the buffer's
+ * `overflowed` flag is set. The function is a no-op when `context` or `data`
+ * is NULL or when `len` is zero.
  *
  * @param context Pointer to a `struct shell_pipe_buffer` to append into.
  * @param data Pointer to the bytes to append.
@@ -166,7 +207,8 @@ static void pipe_buffer_writer(void *context, const char *data, size_t len)
         return;
     }
 
-    size_t remaining = (PIPE_BUFFER_CAPACITY - 1u) - buffer->length;
+    pipe_buffer_reserve(buffer, buffer->length + len);
+    size_t remaining = buffer->capacity ? (buffer->capacity - 1u) - buffer->length : 0;
     if (!remaining) {
         buffer->overflowed = true;
         return;
@@ -615,18 +657,18 @@ static void shell_interrupt_reset_state(void)
 }
 
 /**
- * Handle interrupt signals and flag a pending Ctrl-C request.
+ * Handle Ctrl-C events and flag a pending interrupt request.
  *
- * Sets the internal `shell_interrupt_requested` flag when `signal` is
- * `INTERRUPT_SIGNAL_CTRL_C`, leaving other signals unmodified.
+ * Sets the internal `shell_interrupt_requested` flag when `event` is
+ * `EVENT_CTRL_C`, ignoring other event types.
  *
- * @param signal Interrupt signal delivered to the handler.
+ * @param event Event delivered by the event bus.
  * @param context Unused context pointer (ignored).
  */
-static void shell_interrupt_handler(enum interrupt_signal signal, void *context)
+static void shell_interrupt_handler(const struct event *event, void *context)
 {
     (void)context;
-    if (signal != INTERRUPT_SIGNAL_CTRL_C) {
+    if (event->type != EVENT_CTRL_C) {
         return;
     }
     shell_interrupt_requested = true;
@@ -1323,6 +1365,7 @@ static bool parse_pipeline(char *line, char **segments, size_t *segment_count)
  *
  * Each entry in `segments` is tokenized and looked up in `commands`; for intermediate stages output is captured and supplied
  * as input to the next stage, and the final stage writes to the TTY. Errors and informational messages are written to the TTY.
+ * All stages share one arena for transient allocations, released in one step when the pipeline ends.
  *
  * @param segments Array of null-terminated strings, one per pipeline segment (each segment is a full command line).
  * @param segment_count Number of entries in `segments`.
@@ -1333,11 +1376,14 @@ static bool parse_pipeline(char *line, char **segments, size_t *segment_count)
  */
 static bool execute_pipeline(char **segments, size_t segment_count, const struct shell_command *const *commands, size_t command_count, const struct shell_redirection *redir)
 {
-    char pipe_storage[PIPE_BUFFER_CAPACITY];
-    size_t pipe_storage_len = 0;
-    bool pipe_storage_valid = false;
+    /* Output of the previous stage; ownership moves here from its pipe buffer. */
+    char *pipe_input = 0;
+    size_t pipe_input_len = 0;
+    bool pipe_input_valid = false;
     bool use_redirection = (redir && redir->active);
     struct shell_file_writer file_writer;
+    struct arena arena;
+    bool ok = true;
 
     if (use_redirection) {
         if (!shell_file_writer_init(&file_writer, redir)) {
@@ -1345,12 +1391,15 @@ static bool execute_pipeline(char **segments, size_t segment_count, const struct
         }
     }
 
+    arena_init(&arena);
+
     for (size_t i = 0; i < segment_count; ++i) {
         char *argv_local[MAX_ARGS];
         int argc = tokenize(segments[i], argv_local, MAX_ARGS);
         if (!argc) {
             tty_write_string("Empty command in pipeline.\n");
-            return false;
+            ok = false;
+            break;
         }
 
         const struct shell_command *cmd = find_command(argv_local[0], commands, command_count);
@@ -1358,16 +1407,17 @@ static bool execute_pipeline(char **segments, size_t segment_count, const struct
             tty_write_string("Unknown command: ");
             tty_write_string(argv_local[0]);
             tty_putc('\n');
-            return false;
+            ok = false;
+            break;
         }
 
         bool has_next = (i + 1u) < segment_count;
         struct shell_pipe_buffer pipe_buffer;
         struct shell_io io;
 
-        if (pipe_storage_valid) {
-            io.input = pipe_storage;
-            io.input_len = pipe_storage_len;
+        if (pipe_input_valid) {
+            io.input = pipe_input ? pipe_input : "";
+            io.input_len = pipe_input_len;
         } else {
             io.input = 0;
             io.input_len = 0;
@@ -1384,31 +1434,42 @@ static bool execute_pipeline(char **segments, size_t segment_count, const struct
             io.write = tty_writer;
             io.context = 0;
         }
+        io.arena = &arena;
 
         cmd->handler(argc, argv_local, &io);
 
+        free(pipe_input);
+        pipe_input = 0;
+
         if (shell_interrupt_poll()) {
-            return false;
+            if (has_next) {
+                free(pipe_buffer.data);
+            }
+            ok = false;
+            break;
         }
 
         if (has_next) {
-            pipe_storage_len = pipe_buffer.length;
-            memcpy(pipe_storage, pipe_buffer.data, pipe_storage_len + 1u);
-            pipe_storage_valid = true;
+            pipe_input = pipe_buffer.data;
+            pipe_input_len = pipe_buffer.length;
+            pipe_input_valid = true;
             if (pipe_buffer.overflowed) {
                 tty_write_string("\n[pipe] output truncated (buffer full)\n");
             }
         } else {
-            pipe_storage_valid = false;
-            pipe_storage_len = 0;
+            pipe_input_valid = false;
+            pipe_input_len = 0;
         }
     }
 
-    if (use_redirection) {
+    free(pipe_input);
+    arena_release(&arena);
+
+    if (ok && use_redirection) {
         shell_file_writer_finalize(&file_writer);
     }
 
-    return true;
+    return ok;
 }
 
 /**
@@ -1528,7 +1589,7 @@ void shell_run(void)
     }
 
     if (shell_interrupt_subscription < 0) {
-        shell_interrupt_subscription = interrupt_subscribe(INTERRUPT_SIGNAL_CTRL_C, shell_interrupt_handler, 0);
+        shell_interrupt_subscription = event_subscribe(EVENT_CTRL_C, shell_interrupt_handler, 0);
     }
 
     shell_initialize_working_directory();
@@ -1538,6 +1599,7 @@ void shell_run(void)
     for (;;) {
         shell_interrupt_reset_state();
         prompt();
+        boottime_mark(BOOT_PHASE_PROMPT);
         size_t len = read_line(buffer, sizeof(buffer), commands, command_count);
         if (!len) {
             continue;
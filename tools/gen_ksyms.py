@@ -0,0 +1,97 @@
+#!/usr/bin/env python3
+"""Generate the kernel symbol table (build/ksyms.c) from a linked kernel ELF.
+
+The kernel is linked twice: first with an empty table (--empty), then with the
+table generated from that first link. linker.ld places the .ksyms section after
+.text, .rodata and .data, so filling it in cannot move any function; --check
+re-reads the final ELF and fails the build if that ever stops being true.
+
+    gen_ksyms.py --empty <output.c>
+    gen_ksyms.py <kernel.elf> <output.c>
+    gen_ksyms.py --check <kernel.elf> <ksyms.c>
+"""
+import pathlib
+import struct
+import sys
+
+SHT_SYMTAB = 2
+STT_NOTYPE = 0
+STT_FUNC = 2
+STB_LOCAL = 0
+
+HEADER = """/* Generated by tools/gen_ksyms.py - do not edit. */
+#include <lux/ksyms.h>
+
+#define KSYMS_SECTION __attribute__((section(".ksyms")))
+"""
+
+
+def _cstr(blob, offset):
+    end = blob.index(b"\0", offset)
+    return blob[offset:end].decode("ascii", "replace")
+
+
+def read_symbols(path):
+    data = pathlib.Path(path).read_bytes()
+    if data[:4] != b"\x7fELF" or data[4] != 1 or data[5] != 1:
+        raise SystemExit(f"{path}: not a little-endian ELF32 file")
+
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+    sections = [struct.unpack_from("<IIIIIIIIII", data, shoff + i * shentsize) for i in range(shnum)]
+    shstr = sections[shstrndx]
+    names = [_cstr(data[shstr[4]:shstr[4] + shstr[5]], s[0]) for s in sections]
+
+    symbols = {}
+    for index, sec in enumerate(sections):
+        if sec[1] != SHT_SYMTAB:
+            continue
+        strtab = sections[sec[6]]
+        strings = data[strtab[4]:strtab[4] + strtab[5]]
+        for offset in range(sec[4], sec[4] + sec[5], sec[9]):
+            st_name, value, size, info, _, shndx = struct.unpack_from("<IIIBBH", data, offset)
+            kind = info & 0xF
+            if kind not in (STT_FUNC, STT_NOTYPE) or not st_name or shndx >= len(names):
+                continue
+            if not names[shndx].startswith(".text"):
+                continue
+            name = _cstr(strings, st_name)
+            if name.startswith(".L"):
+                continue
+            # Prefer typed, global, sized symbols when several share an address.
+            rank = (kind == STT_FUNC, (info >> 4) != STB_LOCAL, size != 0)
+            if value not in symbols or rank > symbols[value][0]:
+                symbols[value] = (rank, size, name)
+
+    return [(addr, size, name) for addr, (_, size, name) in sorted(symbols.items())]
+
+
+def render(symbols):
+    lines = [HEADER]
+    lines.append(f"const uint32_t ksym_count KSYMS_SECTION = {len(symbols)}u;\n")
+    lines.append("const struct ksym ksym_table[] KSYMS_SECTION = {")
+    offset = 0
+    for addr, size, name in symbols:
+        lines.append(f"    {{ 0x{addr:08x}u, {size}u, {offset}u }}, /* {name} */")
+        offset += len(name) + 1
+    lines.append("    { 0xffffffffu, 0u, 0u } /* sentinel */")
+    lines.append("};\n")
+    lines.append("const char ksym_names[] KSYMS_SECTION =")
+    for _, _, name in symbols:
+        lines.append(f'    "{name}\\0"')
+    lines.append('    "";')
+    return "\n".join(lines) + "\n"
+
+
+args = sys.argv[1:]
+if len(args) == 2 and args[0] == "--empty":
+    pathlib.Path(args[1]).write_text(render([]))
+elif len(args) == 3 and args[0] == "--check":
+    if render(read_symbols(args[1])) != pathlib.Path(args[2]).read_text():
+        raise SystemExit(f"{args[1]}: symbol addresses moved after embedding {args[2]}")
+elif len(args) == 2:
+    symbols = read_symbols(args[0])
+    pathlib.Path(args[1]).write_text(render(symbols))
+    print(f"{args[0]}: {len(symbols)} symbols")
+else:
+    raise SystemExit("usage: gen_ksyms.py [--empty <out.c> | <kernel.elf> <out.c> | --check <kernel.elf> <ksyms.c>]")
@@ -0,0 +1,477 @@
+/*
+ * Date: 2026-10-16 00:00 UTC
+ * Author: Lukas Fend <lukas.fend@outlook.com>
+ * Description: Host-side benchmark that replays allocation traces against the kernel allocator.
+ *
+ * Built by `make host-bench`, which compiles malloc.c, slab.c and page_alloc.c
+ * for the host with malloc/free/calloc/realloc renamed to lux_*. The kernel's
+ * "physical memory" is a fixed mapping at BENCH_MEMORY_BASE described to the
+ * page allocator through a fake boot_info.
+ *
+ * Usage: heap_bench [trace...]
+ *
+ * Without arguments the built-in synthetic workloads run. A trace file holds
+ * one operation per line, '#' starts a comment:
+ *   a <id> <size>   allocate <size> bytes into slot <id>
+ *   r <id> <size>   resize slot <id>
+ *   f <id>          free slot <id>
+ * Slot ids are below BENCH_MAX_SLOTS. Every workload runs in a forked child so
+ * it starts from a freshly initialized allocator.
+ */
+#define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <lux/boot.h>
+#include <lux/event.h>
+#include <lux/memory.h>
+
+#define BENCH_MEMORY_BASE     0x10000000ul
+#define BENCH_MEMORY_SIZE     (256ul << 20)
+#define BENCH_MAX_SLOTS       4096u
+#define BENCH_SAMPLE_INTERVAL 64u /* operations between fragmentation samples */
+
+void *lux_malloc(size_t size);
+void lux_free(void *ptr);
+void *lux_realloc(void *ptr, size_t size);
+
+struct bench_run {
+    const char *name;
+    uint8_t *slots[BENCH_MAX_SLOTS];
+    size_t sizes[BENCH_MAX_SLOTS];
+    size_t ops;
+    size_t failures;
+    size_t corruptions;
+    uint64_t total_ns;
+    uint64_t worst_ns;
+    size_t peak_used;
+    double worst_fragmentation;
+    uint64_t rng;
+};
+
+static struct boot_info bench_boot;
+
+const struct boot_info *boot_info_get(void)
+{
+    return &bench_boot;
+}
+
+bool event_post(enum event_type type, uint32_t data)
+{
+    (void)type;
+    (void)data;
+    return true;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t bench_rand(struct bench_run *run)
+{
+    run->rng ^= run->rng << 13;
+    run->rng ^= run->rng >> 7;
+    run->rng ^= run->rng << 17;
+    return run->rng;
+}
+
+static size_t bench_range(struct bench_run *run, size_t low, size_t high)
+{
+    return low + (size_t)(bench_rand(run) % (high - low + 1u));
+}
+
+/**
+ * Map the fake physical memory and bring up the page allocator and heap.
+ *
+ * @returns `true` on success, `false` if the fixed mapping is unavailable.
+ */
+static bool bench_memory_init(void)
+{
+    void *memory = mmap((void *)BENCH_MEMORY_BASE, BENCH_MEMORY_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (memory != (void *)BENCH_MEMORY_BASE) {
+        perror("heap_bench: mmap");
+        return false;
+    }
+
+    memset(&bench_boot, 0, sizeof(bench_boot));
+    bench_boot.loader = BOOT_LOADER_UNKNOWN;
+    bench_boot.mmap_count = 1;
+    bench_boot.mmap[0].base = BENCH_MEMORY_BASE;
+    bench_boot.mmap[0].length = BENCH_MEMORY_SIZE;
+    bench_boot.mmap[0].type = BOOT_MMAP_AVAILABLE;
+
+    page_alloc_init();
+    heap_init();
+    return true;
+}
+
+static inline uint8_t bench_tag(size_t id)
+{
+    return (uint8_t)(id ^ (id >> 8) ^ 0xA5u);
+}
+
+/**
+ * Stamp the first and last byte of a slot so later operations can detect overlap.
+ */
+static void bench_stamp(struct bench_run *run, size_t id)
+{
+    uint8_t *ptr = run->slots[id];
+    ptr[0] = bench_tag(id);
+    ptr[run->sizes[id] - 1u] = bench_tag(id);
+}
+
+static bool bench_check(const struct bench_run *run, size_t id)
+{
+    const uint8_t *ptr = run->slots[id];
+    return ptr[0] == bench_tag(id) && ptr[run->sizes[id] - 1u] == bench_tag(id);
+}
+
+static void bench_sample(struct bench_run *run)
+{
+    struct heap_stats stats;
+    if (!heap_get_stats(&stats)) {
+        return;
+    }
+
+    if (stats.used_bytes > run->peak_used) {
+        run->peak_used = stats.used_bytes;
+    }
+    if (stats.free_bytes) {
+        double fragmentation = 1.0 - (double)stats.largest_free_block / (double)stats.free_bytes;
+        if (fragmentation > run->worst_fragmentation) {
+            run->worst_fragmentation = fragmentation;
+        }
+    }
+}
+
+/**
+ * Execute one trace operation against the kernel allocator and time it.
+ *
+ * @param run Workload state.
+ * @param op 'a' (allocate), 'r' (resize) or 'f' (free).
+ * @param id Slot the operation applies to.
+ * @param size Requested size for 'a' and 'r'.
+ */
+static void bench_op(struct bench_run *run, char op, size_t id, size_t size)
+{
+    if (id >= BENCH_MAX_SLOTS) {
+        ++run->failures;
+        return;
+    }
+
+    if (run->slots[id] && !bench_check(run, id)) {
+        ++run->corruptions;
+    }
+
+    uint64_t start = now_ns();
+    void *result = 0;
+    switch (op) {
+    case 'a':
+        lux_free(run->slots[id]);
+        result = lux_malloc(size);
+        break;
+    case 'r':
+        result = lux_realloc(run->slots[id], size);
+        break;
+    case 'f':
+        lux_free(run->slots[id]);
+        break;
+    default:
+        ++run->failures;
+        return;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    run->total_ns += elapsed;
+    if (elapsed > run->worst_ns) {
+        run->worst_ns = elapsed;
+    }
+    ++run->ops;
+
+    if (op == 'f' || !size) {
+        run->slots[id] = 0;
+        run->sizes[id] = 0;
+    } else if (!result) {
+        ++run->failures;
+        if (op == 'a') {
+            run->slots[id] = 0;
+            run->sizes[id] = 0;
+        }
+    } else {
+        run->slots[id] = result;
+        run->sizes[id] = size;
+        bench_stamp(run, id);
+    }
+
+    if (run->ops % BENCH_SAMPLE_INTERVAL == 0) {
+        bench_sample(run);
+    }
+}
+
+static void bench_free_all(struct bench_run *run)
+{
+    for (size_t id = 0; id < BENCH_MAX_SLOTS; ++id) {
+        if (run->slots[id]) {
+            bench_op(run, 'f', id, 0);
+        }
+    }
+}
+
+/**
+ * Shell session: per command line a few argument strings and a pipe buffer
+ * that doubles from 1 KiB, plus occasional long-lived allocations.
+ */
+static void workload_shell(struct bench_run *run)
+{
+    const size_t long_lived = 256u;
+    for (size_t line = 0; line < 40000u; ++line) {
+        size_t args = bench_range(run, 1u, 6u);
+        for (size_t i = 0; i < args; ++i) {
+            bench_op(run, 'a', long_lived + i, bench_range(run, 8u, 128u));
+        }
+
+        size_t pipe = long_lived + 8u;
+        size_t capacity = 1024u;
+        size_t output = bench_range(run, 16u, 16384u);
+        bench_op(run, 'r', pipe, capacity);
+        while (capacity < output) {
+            capacity *= 2u;
+            bench_op(run, 'r', pipe, capacity);
+        }
+
+        for (size_t i = args; i > 0; --i) {
+            bench_op(run, 'f', long_lived + i - 1u, 0);
+        }
+        bench_op(run, 'f', pipe, 0);
+
+        if (bench_range(run, 0u, 49u) == 0) {
+            bench_op(run, 'a', bench_range(run, 0u, long_lived - 1u), bench_range(run, 32u, 4096u));
+        }
+    }
+    bench_free_all(run);
+}
+
+/**
+ * less loads: a file-sized buffer, a line array grown by doubling and trimmed,
+ * with a small allocation left behind after every load to pin the heap.
+ */
+static void workload_less(struct bench_run *run)
+{
+    const size_t data = 0;
+    const size_t lines = 1;
+    for (size_t load = 0; load < 2000u; ++load) {
+        size_t size = bench_range(run, 1024u, 512u * 1024u);
+        bench_op(run, 'a', data, size + 1u);
+
+        size_t line_count = size / 40u + 1u;
+        size_t capacity = 64u;
+        bench_op(run, 'a', lines, capacity * sizeof(char *));
+        while (capacity < line_count) {
+            capacity *= 2u;
+            bench_op(run, 'r', lines, capacity * sizeof(char *));
+        }
+        bench_op(run, 'r', lines, line_count * sizeof(char *));
+
+        bench_op(run, 'a', 16u + load % 512u, bench_range(run, 16u, 256u));
+        bench_op(run, 'f', lines, 0);
+        bench_op(run, 'f', data, 0);
+    }
+    bench_free_all(run);
+}
+
+/**
+ * Swap file growth: several files doubling from 512 bytes via realloc,
+ * occasionally released and started over.
+ */
+static void workload_swap(struct bench_run *run)
+{
+    const size_t files = 8u;
+    size_t capacity[8] = {0};
+    for (size_t step = 0; step < 20000u; ++step) {
+        size_t file = bench_range(run, 0u, files - 1u);
+        if (capacity[file] && bench_range(run, 0u, 15u) == 0) {
+            bench_op(run, 'f', file, 0);
+            capacity[file] = 0;
+            continue;
+        }
+
+        size_t target = bench_range(run, 512u, 1024u * 1024u);
+        size_t grown = capacity[file] ? capacity[file] : 512u;
+        while (grown < target) {
+            grown *= 2u;
+        }
+        if (grown != capacity[file]) {
+            bench_op(run, 'r', file, grown);
+            capacity[file] = grown;
+        }
+    }
+    bench_free_all(run);
+}
+
+/**
+ * Random mix: mostly small objects with random lifetimes, some medium and a
+ * few large ones, with resizes in between.
+ */
+static void workload_random(struct bench_run *run)
+{
+    for (size_t step = 0; step < 400000u; ++step) {
+        size_t id = bench_range(run, 0u, 2047u);
+        size_t roll = bench_range(run, 0u, 99u);
+        size_t size;
+        if (roll < 80u) {
+            size = bench_range(run, 1u, 256u);
+        } else if (roll < 98u) {
+            size = bench_range(run, 257u, 8192u);
+        } else {
+            size = bench_range(run, 8193u, 256u * 1024u);
+        }
+
+        if (!run->slots[id]) {
+            bench_op(run, 'a', id, size);
+        } else if (bench_range(run, 0u, 3u) == 0) {
+            bench_op(run, 'r', id, size);
+        } else {
+            bench_op(run, 'f', id, 0);
+        }
+    }
+    bench_free_all(run);
+}
+
+/**
+ * Replay a recorded trace file.
+ *
+ * @returns `true` if the file could be read, `false` otherwise.
+ */
+static bool workload_trace(struct bench_run *run, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        char op;
+        unsigned long id;
+        unsigned long size = 0;
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        if (sscanf(line, " %c %lu %lu", &op, &id, &size) < 2) {
+            ++run->failures;
+            continue;
+        }
+        bench_op(run, op, (size_t)id, (size_t)size);
+    }
+
+    fclose(file);
+    bench_free_all(run);
+    return true;
+}
+
+static void bench_report(const struct bench_run *run)
+{
+    double seconds = (double)run->total_ns / 1e9;
+    struct heap_stats stats;
+    double final_fragmentation = 0.0;
+    if (heap_get_stats(&stats) && stats.free_bytes) {
+        final_fragmentation = 1.0 - (double)stats.largest_free_block / (double)stats.free_bytes;
+    }
+
+    printf("%-16s %9zu %9.2f %8.0f %9llu %11zu %9.1f%% %8.1f%% %6zu %6zu\n",
+           run->name,
+           run->ops,
+           seconds > 0.0 ? (double)run->ops / seconds / 1e6 : 0.0,
+           run->ops ? (double)run->total_ns / (double)run->ops : 0.0,
+           (unsigned long long)run->worst_ns,
+           run->peak_used,
+           run->worst_fragmentation * 100.0,
+           final_fragmentation * 100.0,
+           run->failures,
+           run->corruptions);
+}
+
+/**
+ * Run one workload in a child process with a fresh allocator.
+ *
+ * @returns `true` if the workload completed without corruption.
+ */
+static bool bench_run_workload(const char *name, void (*workload)(struct bench_run *), const char *trace)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("heap_bench: fork");
+        return false;
+    }
+
+    if (pid == 0) {
+        static struct bench_run run;
+        run.name = name;
+        run.rng = 0x9E3779B97F4A7C15ull;
+        if (!bench_memory_init()) {
+            _exit(2);
+        }
+        if (workload) {
+            workload(&run);
+        } else if (!workload_trace(&run, trace)) {
+            _exit(2);
+        }
+        bench_report(&run);
+        fflush(stdout);
+        _exit(run.corruptions ? 1 : 0);
+    }
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) < 0) {
+        perror("heap_bench: waitpid");
+        return false;
+    }
+    if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+        fprintf(stderr, "heap_bench: workload %s failed\n", name);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    static const struct {
+        const char *name;
+        void (*run)(struct bench_run *);
+    } workloads[] = {
+        {"shell-session", workload_shell},
+        {"less-load", workload_less},
+        {"swap-growth", workload_swap},
+        {"random-mix", workload_random},
+    };
+    bool ok = true;
+
+    printf("%-16s %9s %9s %8s %9s %11s %10s %9s %6s %6s\n",
+           "workload", "ops", "Mops/s", "avg ns", "worst ns", "peak used", "frag max", "frag end", "fail", "corrupt");
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) {
+            ok &= bench_run_workload(argv[i], 0, argv[i]);
+        }
+    } else {
+        for (size_t i = 0; i < sizeof(workloads) / sizeof(workloads[0]); ++i) {
+            ok &= bench_run_workload(workloads[i].name, workloads[i].run, 0);
+        }
+    }
+
+    printf("fragmentation = 1 - largest free block / free bytes (heap arenas only; slab objects excluded)\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""Compress the flat kernel binary into a single LZ4 block for the boot stub.
+
+Output layout (little endian), consumed by src/arch/x86/boot/decompress.asm:
+
+    u32 magic              "LZ4K"
+    u32 uncompressed size
+    u32 compressed size
+    ... LZ4 block data
+"""
+import pathlib
+import struct
+import sys
+
+MAGIC = 0x4B345A4C  # "LZ4K"
+
+MIN_MATCH = 4
+LAST_LITERALS = 5
+MFLIMIT = 12
+MAX_OFFSET = 0xFFFF
+HASH_BITS = 16
+MAX_CHAIN = 64
+
+
+def _write_length(out, length):
+    while length >= 255:
+        out.append(255)
+        length -= 255
+    out.append(length)
+
+
+def _emit(out, literals, match_len, offset):
+    lit_len = len(literals)
+    token = min(lit_len, 15) << 4
+    if match_len:
+        token |= min(match_len - MIN_MATCH, 15)
+    out.append(token)
+    if lit_len >= 15:
+        _write_length(out, lit_len - 15)
+    out += literals
+    if match_len:
+        out += struct.pack("<H", offset)
+        if match_len - MIN_MATCH >= 15:
+            _write_length(out, match_len - MIN_MATCH - 15)
+
+
+def compress(data):
+    size = len(data)
+    out = bytearray()
+    head = {}
+    prev = [0] * size
+    anchor = 0
+    pos = 0
+    match_limit = size - MFLIMIT
+    end_limit = size - LAST_LITERALS
+
+    def insert(i):
+        key = data[i:i + MIN_MATCH]
+        prev[i] = head.get(key, -1)
+        head[key] = i
+
+    while pos < match_limit:
+        best_len = 0
+        best_off = 0
+        candidate = head.get(data[pos:pos + MIN_MATCH], -1)
+        chain = MAX_CHAIN
+        while candidate >= 0 and pos - candidate <= MAX_OFFSET and chain:
+            length = 0
+            while pos + length < end_limit and data[candidate + length] == data[pos + length]:
+                length += 1
+            if length > best_len:
+                best_len = length
+                best_off = pos - candidate
+            candidate = prev[candidate]
+            chain -= 1
+
+        if best_len < MIN_MATCH:
+            insert(pos)
+            pos += 1
+            continue
+
+        _emit(out, data[anchor:pos], best_len, best_off)
+        for i in range(pos, min(pos + best_len, match_limit)):
+            insert(i)
+        pos += best_len
+        anchor = pos
+
+    _emit(out, data[anchor:], 0, 0)
+    return bytes(out)
+
+
+def decompress(block, size):
+    out = bytearray()
+    i = 0
+    while i < len(block):
+        token = block[i]
+        i += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            while True:
+                extra = block[i]
+                i += 1
+                lit_len += extra
+                if extra != 255:
+                    break
+        out += block[i:i + lit_len]
+        i += lit_len
+        if i >= len(block):
+            break
+        offset = block[i] | (block[i + 1] << 8)
+        i += 2
+        match_len = token & 15
+        if match_len == 15:
+            while True:
+                extra = block[i]
+                i += 1
+                match_len += extra
+                if extra != 255:
+                    break
+        match_len += MIN_MATCH
+        start = len(out) - offset
+        for j in range(match_len):
+            out.append(out[start + j])
+    if len(out) != size:
+        raise ValueError("decompressed size mismatch")
+    return bytes(out)
+
+
+if len(sys.argv) != 3:
+    raise SystemExit("usage: lz4_pack.py <kernel.bin> <output>")
+
+src = pathlib.Path(sys.argv[1])
+dst = pathlib.Path(sys.argv[2])
+raw = src.read_bytes()
+block = compress(raw)
+
+if decompress(block, len(raw)) != raw:
+    raise SystemExit(f"{src}: LZ4 round trip failed")
+
+dst.write_bytes(struct.pack("<III", MAGIC, len(raw), len(block)) + block)
+print(f"{src}: {len(raw)} -> {len(block)} bytes")
@@ -14,6 +14,11 @@ if len(sys.argv) != 2:
 path = pathlib.Path(sys.argv[1])
 size = path.stat().st_size
 
+if size > LUXFS_START_LBA * SECTOR_SIZE:
+    raise SystemExit(
+        f"{path}: boot + kernel image ({size} bytes) overlaps the filesystem at LBA {LUXFS_START_LBA}"
+    )
+
 target = size
 if target < MIN_DISK_SIZE:
     target = MIN_DISK_SIZE